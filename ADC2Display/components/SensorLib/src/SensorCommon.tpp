@@ -32,6 +32,7 @@
 #pragma once
 
 #include "SensorLib.h"
+#include "SensorRegField.hpp"
 
 typedef union  {
     struct {
@@ -46,6 +47,58 @@ typedef void    (*gpio_write_fptr_t)(uint32_t gpio, uint8_t value);
 typedef int     (*gpio_read_fptr_t)(uint32_t gpio);
 typedef void    (*gpio_mode_fptr_t)(uint32_t gpio, uint8_t mode);
 typedef void    (*delay_ms_fptr_t)(uint32_t ms);
+typedef void    (*async_done_fptr_t)(int result, void *user_data);
+#if defined(SENSORLIB_HOST)
+// A whole write transaction, register address first, as it goes on the wire
+typedef int     (*iic_transmit_fptr_t)(uint8_t devAddr, const uint8_t *data, size_t len);
+#endif
+
+typedef struct {
+    async_done_fptr_t   done;
+    void                *user_data;
+    uint8_t             tx[SENSORLIB_ASYNC_WRITE_SIZE];
+} SensorAsyncSlot_t;
+
+enum SensorBusOp {
+    SENSORLIB_BUS_READ,
+    SENSORLIB_BUS_WRITE,
+    SENSORLIB_BUS_WRITE_READ,
+};
+
+typedef struct {
+    uint32_t    start_us;       // Low 32 bits of the microsecond clock
+    uint32_t    duration_us;
+    uint16_t    reg;
+    uint8_t     op;             // SensorBusOp
+    uint8_t     length;         // Data bytes, register address excluded
+    int8_t      result;
+} SensorBusTraceEntry_t;
+
+typedef struct {
+    uint32_t    transfers[3];   // Per SensorBusOp
+    uint32_t    bytes_read;
+    uint32_t    bytes_written;
+    uint32_t    errors;
+    uint32_t    max_us;
+    uint64_t    total_us;
+    // Bucket n counts transfers of 2^n to 2^(n+1) - 1 us, the first one
+    // includes 0 us and the last one everything longer
+    uint32_t    histogram[SENSORLIB_BUS_TRACE_BUCKETS];
+} SensorBusStats_t;
+
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+#if defined(ARDUINO)
+#define SENSORLIB_TRACE_PRINTF(...)                 Serial.printf(__VA_ARGS__)
+#else
+#include <stdio.h>
+#define SENSORLIB_TRACE_PRINTF(...)                 printf(__VA_ARGS__)
+#endif
+#define SENSORLIB_TRACE_START()                     uint32_t __trace_start = SENSORLIB_MICROS()
+#define SENSORLIB_TRACE_END(op, reg, length, ret)   traceBus(op, reg, length, ret, __trace_start)
+#else
+#define SENSORLIB_TRACE_START()
+#define SENSORLIB_TRACE_END(op, reg, length, ret)
+#endif
 
 template <class chipType>
 class SensorCommon
@@ -57,6 +110,20 @@ public:
         if (__spiSetting) {
             delete __spiSetting;
         }
+#endif
+        if (__reg_cache) {
+            free(__reg_cache);
+        }
+#if defined(SENSORLIB_I2C_ASYNC)
+        if (__i2c_async_device) {
+            waitAsync(SENSORLIB_I2C_MASTER_TIMEOUT_MS);
+            i2c_master_bus_rm_device(__i2c_async_device);
+        }
+#endif
+#if defined(ESP_PLATFORM) && !defined(ARDUINO)
+        if (__spi_device) {
+            spi_bus_remove_device(__spi_device);
+        }
 #endif
     }
 
@@ -215,6 +282,67 @@ public:
     }
 #endif //ESP 5.X
 
+    void setSpiSetting(uint32_t freq, uint8_t dataMode = 0)
+    {
+        __freq = freq;
+        __dataMode = dataMode;
+    }
+
+    /**
+     * @brief Attach the device to an ESP-IDF SPI host. With the three bus pins
+     *        given the bus is initialized here with DMA, otherwise it has to
+     *        be initialized already, e.g. because it is shared with a display.
+     * @note  Call setSpiSetting() before to change the clock or the mode.
+     */
+    bool begin(spi_host_device_t host, int cs, int mosi = -1, int miso = -1, int sck = -1)
+    {
+        log_i("Using ESP-IDF SPI interface.\n");
+        if (__has_init)return thisChip().initImpl();
+        __cs = cs;
+        __mosi = mosi;
+        __miso = miso;
+        __sck = sck;
+        __i2c_master_read = NULL;
+        __i2c_master_write = NULL;
+
+        if (mosi != -1 && miso != -1 && sck != -1) {
+            spi_bus_config_t bus_conf;
+            memset(&bus_conf, 0, sizeof(bus_conf));
+            bus_conf.mosi_io_num = mosi;
+            bus_conf.miso_io_num = miso;
+            bus_conf.sclk_io_num = sck;
+            bus_conf.quadwp_io_num = -1;
+            bus_conf.quadhd_io_num = -1;
+            // ESP_ERR_INVALID_STATE, the bus was initialized by someone else
+            esp_err_t err = spi_bus_initialize(host, &bus_conf, SPI_DMA_CH_AUTO);
+            if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+                log_i("spi_bus_initialize failed !\n");
+                return false;
+            }
+        }
+
+        // No command phase, the register address goes in the address phase
+        // with the length set per transfer
+        spi_device_interface_config_t dev_conf;
+        memset(&dev_conf, 0, sizeof(dev_conf));
+        dev_conf.mode = __dataMode;
+        dev_conf.clock_speed_hz = __freq;
+        dev_conf.spics_io_num = cs;
+        dev_conf.queue_size = 1;
+        if (ESP_OK != spi_bus_add_device(host, &dev_conf, &__spi_device)) {
+            log_i("spi_bus_add_device failed !\n");
+            __spi_device = NULL;
+            return false;
+        }
+        __readMask = thisChip().getReadMaskImpl();
+        __has_init = thisChip().initImpl();
+        if (!__has_init) {
+            spi_bus_remove_device(__spi_device);
+            __spi_device = NULL;
+        }
+        return __has_init;
+    }
+
 #endif
 
 
@@ -232,6 +360,22 @@ public:
         return __has_init;
     }
 
+#if defined(SENSORLIB_HOST)
+    // Register writes are joined with their address in one buffer, the way
+    // the ESP-IDF I2C driver sends them, before transmitCallback gets them
+    bool begin(uint8_t addr, iic_fptr_t readRegCallback, iic_transmit_fptr_t transmitCallback)
+    {
+        log_i("Using Custom transmit interface.\n");
+        if (__has_init)return thisChip().initImpl();
+        __i2c_master_read = readRegCallback;
+        __i2c_master_write = NULL;
+        __i2c_master_transmit = transmitCallback;
+        __addr = addr;
+        __has_init = thisChip().initImpl();
+        return __has_init;
+    }
+#endif
+
     void setGpioWriteCallback(gpio_write_fptr_t cb)
     {
         __set_gpio_level = cb;
@@ -252,6 +396,270 @@ public:
         __delay_ms = cb;
     }
 
+    // Heap allocations made by register writes. Only writes that do not fit
+    // in SENSORLIB_WRITE_BUFFER_SIZE allocate, every write if it is 0.
+    uint32_t getWriteAllocations() const
+    {
+        return __write_allocations;
+    }
+
+    /**
+     * @brief Keep a write-through copy of the registers the chip does not
+     *        change by itself, so bit updates skip the bus read.
+     * @note  Only drivers implementing isVolatileRegisterImpl() declare such
+     *        registers, for the others everything stays on the bus.
+     */
+    bool enableRegisterCache(bool enable = true)
+    {
+        if (!enable) {
+            if (__reg_cache) {
+                free(__reg_cache);
+                __reg_cache = NULL;
+            }
+            return true;
+        }
+        if (!__reg_cache) {
+            // Register values followed by one valid bit per register
+            __reg_cache = (uint8_t *)malloc(SENSORLIB_REG_CACHE_SIZE + SENSORLIB_REG_CACHE_SIZE / 8);
+            if (!__reg_cache) {
+                return false;
+            }
+        }
+        invalidateRegisterCache();
+        return true;
+    }
+
+    // Drop every cached value, e.g. after a chip reset
+    void invalidateRegisterCache()
+    {
+        if (__reg_cache) {
+            memset(__reg_cache + SENSORLIB_REG_CACHE_SIZE, 0, SENSORLIB_REG_CACHE_SIZE / 8);
+        }
+    }
+
+    /**
+     * @brief Let readRegisterAsync() and writeRegisterAsync() return before
+     *        the transfer is over. Needs the ESP-IDF I2C master bus to be
+     *        created with trans_queue_depth of at least SENSORLIB_ASYNC_DEPTH.
+     * @note  The transfers go through a second device handle with the same
+     *        address, the blocking calls keep using the first one.
+     * @retval false when the transfers will complete before the call returns.
+     */
+    bool enableAsync()
+    {
+#if defined(SENSORLIB_I2C_ASYNC)
+        if (__i2c_async_device) {
+            return true;
+        }
+        if (!__has_init || __i2c_master_read || __i2c_master_write || __spi_device) {
+            return false;
+        }
+        if (ESP_OK != i2c_master_bus_add_device(bus_handle, &__i2c_dev_conf, &__i2c_async_device)) {
+            log_i("i2c_master_bus_add_device failed !\n");
+            __i2c_async_device = NULL;
+            return false;
+        }
+        i2c_master_event_callbacks_t cbs;
+        memset(&cbs, 0, sizeof(cbs));
+        cbs.on_trans_done = asyncDone;
+        if (ESP_OK != i2c_master_register_event_callbacks(__i2c_async_device, &cbs, this)) {
+            log_i("Bus is not asynchronous, trans_queue_depth is 0 ?\n");
+            i2c_master_bus_rm_device(__i2c_async_device);
+            __i2c_async_device = NULL;
+            return false;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Start a register read, \p done gets the result once \p buf is filled.
+     * @note  \p buf must stay valid until then. \p done runs in the I2C
+     *        interrupt, without enableAsync() it runs before this returns.
+     * @retval DEV_WIRE_BUSY when SENSORLIB_ASYNC_DEPTH transfers are in flight.
+     */
+    int readRegisterAsync(int reg, uint8_t *buf, uint8_t length, async_done_fptr_t done, void *user_data)
+    {
+#if defined(SENSORLIB_I2C_ASYNC)
+        if (__i2c_async_device) {
+            if (__batch_len && batchAffects(reg, length)) {
+                flushBatch();
+            }
+            SensorAsyncSlot_t *slot = asyncSlot(done, user_data);
+            if (!slot) {
+                return DEV_WIRE_BUSY;
+            }
+            memcpy(slot->tx, &reg, __reg_addr_len);
+            if (ESP_OK != i2c_master_transmit_receive(__i2c_async_device, slot->tx, __reg_addr_len,
+                    buf, length, SENSORLIB_I2C_MASTER_TIMEOUT_MS)) {
+                __async_head--;
+                return DEV_WIRE_ERR;
+            }
+            return DEV_WIRE_NONE;
+        }
+#endif
+        int ret = readRegister(reg, buf, length);
+        if (done) {
+            done(ret, user_data);
+        }
+        return DEV_WIRE_NONE;
+    }
+
+    /**
+     * @brief Start a register write, the data is copied and \p buf can be
+     *        reused right away. Up to SENSORLIB_ASYNC_WRITE_SIZE bytes
+     *        including the register address.
+     * @note  Cached values of the written registers are dropped. An open
+     *        batch is sent first, so the writes reach the chip in order.
+     */
+    int writeRegisterAsync(int reg, const uint8_t *buf, uint8_t length, async_done_fptr_t done, void *user_data)
+    {
+        if (length + __reg_addr_len > SENSORLIB_ASYNC_WRITE_SIZE) {
+            return DEV_WIRE_ERR;
+        }
+#if defined(SENSORLIB_I2C_ASYNC)
+        if (__i2c_async_device) {
+            if (__batch_len) {
+                flushBatch();
+            }
+            SensorAsyncSlot_t *slot = asyncSlot(done, user_data);
+            if (!slot) {
+                return DEV_WIRE_BUSY;
+            }
+            for (int i = 0; i < length; ++i) {
+                uncacheRegister(reg + i);
+            }
+            memcpy(slot->tx, &reg, __reg_addr_len);
+            memcpy(slot->tx + __reg_addr_len, buf, length);
+            if (ESP_OK != i2c_master_transmit(__i2c_async_device, slot->tx, __reg_addr_len + length,
+                                              SENSORLIB_I2C_MASTER_TIMEOUT_MS)) {
+                __async_head--;
+                return DEV_WIRE_ERR;
+            }
+            return DEV_WIRE_NONE;
+        }
+#endif
+        uint8_t data[SENSORLIB_ASYNC_WRITE_SIZE];
+        memcpy(data, buf, length);
+        int ret = writeRegister(reg, data, length);
+        if (done) {
+            done(ret, user_data);
+        }
+        return DEV_WIRE_NONE;
+    }
+
+    // Asynchronous transfers not completed yet
+    uint8_t getAsyncPending() const
+    {
+        return (uint8_t)(__async_head - __async_tail);
+    }
+
+    // Wait for the asynchronous transfers in flight, false on timeout
+    bool waitAsync(uint32_t timeout_ms)
+    {
+#if defined(SENSORLIB_I2C_ASYNC)
+        uint32_t start = millis();
+        while (getAsyncPending()) {
+            if (millis() - start > timeout_ms) {
+                return false;
+            }
+            delay(1);
+        }
+#endif
+        return true;
+    }
+
+    // Read-modify-write reads served from the cache
+    uint32_t getRegisterCacheHits() const
+    {
+        return __reg_cache_hits;
+    }
+
+    // Read-modify-write reads that went to the bus with the cache enabled
+    uint32_t getRegisterCacheMisses() const
+    {
+        return __reg_cache_misses;
+    }
+
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+    /**
+     * @brief Transfers, bytes, errors and latencies since begin() or the
+     *        last resetBusStats(). Asynchronous transfers queued on the
+     *        ESP-IDF bus are not included.
+     */
+    const SensorBusStats_t &getBusStats() const
+    {
+        return __bus_stats;
+    }
+
+    void resetBusStats()
+    {
+        memset(&__bus_stats, 0, sizeof(__bus_stats));
+    }
+
+    /**
+     * @brief Copy the most recent transfers, oldest first.
+     * @retval Number of entries copied, at most SENSORLIB_BUS_TRACE_DEPTH.
+     */
+    uint8_t getBusTrace(SensorBusTraceEntry_t *entries, uint8_t max)
+    {
+#if SENSORLIB_BUS_TRACE_DEPTH > 0
+        uint32_t n = __trace_count < SENSORLIB_BUS_TRACE_DEPTH ? __trace_count : SENSORLIB_BUS_TRACE_DEPTH;
+        if (n > max) {
+            n = max;
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            entries[i] = __trace_ring[(__trace_count - n + i) % SENSORLIB_BUS_TRACE_DEPTH];
+        }
+        return (uint8_t)n;
+#else
+        (void)entries;
+        (void)max;
+        return 0;
+#endif
+    }
+
+    void dumpBusStats()
+    {
+        const SensorBusStats_t &s = __bus_stats;
+        uint32_t count = s.transfers[SENSORLIB_BUS_READ] + s.transfers[SENSORLIB_BUS_WRITE] +
+                         s.transfers[SENSORLIB_BUS_WRITE_READ];
+        SENSORLIB_TRACE_PRINTF("[0x%02X] reads:%lu writes:%lu write_reads:%lu rx:%lu tx:%lu errors:%lu avg_us:%lu max_us:%lu\n",
+                   __addr, (unsigned long)s.transfers[SENSORLIB_BUS_READ],
+                   (unsigned long)s.transfers[SENSORLIB_BUS_WRITE],
+                   (unsigned long)s.transfers[SENSORLIB_BUS_WRITE_READ],
+                   (unsigned long)s.bytes_read, (unsigned long)s.bytes_written, (unsigned long)s.errors,
+                   (unsigned long)(count ? s.total_us / count : 0), (unsigned long)s.max_us);
+        for (int i = 0; i < SENSORLIB_BUS_TRACE_BUCKETS; ++i) {
+            if (!s.histogram[i]) {
+                continue;
+            }
+            // The last bucket has no upper bound
+            if (i == SENSORLIB_BUS_TRACE_BUCKETS - 1) {
+                SENSORLIB_TRACE_PRINTF(" >=%6lu us: %lu\n", (unsigned long)(1UL << i), (unsigned long)s.histogram[i]);
+            } else {
+                SENSORLIB_TRACE_PRINTF("  <%6lu us: %lu\n", (unsigned long)(2UL << i), (unsigned long)s.histogram[i]);
+            }
+        }
+    }
+
+    void dumpBusTrace()
+    {
+#if SENSORLIB_BUS_TRACE_DEPTH > 0
+        static const char *const names[] = {"R ", "W ", "WR"};
+        SensorBusTraceEntry_t entries[SENSORLIB_BUS_TRACE_DEPTH];
+        uint8_t n = getBusTrace(entries, SENSORLIB_BUS_TRACE_DEPTH);
+        for (uint8_t i = 0; i < n; ++i) {
+            const SensorBusTraceEntry_t &e = entries[i];
+            SENSORLIB_TRACE_PRINTF("[0x%02X] %10lu %s reg:0x%04X len:%3u %5lu us%s\n", __addr, (unsigned long)e.start_us,
+                       names[e.op], e.reg, e.length, (unsigned long)e.duration_us, e.result ? " ERR" : "");
+        }
+#endif
+    }
+#endif
+
 protected:
 
     inline void setGpioMode(uint32_t gpio, uint8_t mode)
@@ -308,7 +716,7 @@ protected:
     //! Write method
     int writeRegister(uint8_t reg, uint8_t norVal, uint8_t orVal)
     {
-        int val = readRegister(reg);
+        int val = readRegisterCached(reg);
         if (val == DEV_WIRE_ERR) {
             return DEV_WIRE_ERR;
         }
@@ -328,6 +736,14 @@ protected:
     }
 
     int writeThenRead(uint8_t *write_buffer, uint8_t write_len, uint8_t *read_buffer, uint8_t read_len)
+    {
+        SENSORLIB_TRACE_START();
+        int ret = writeThenReadBus(write_buffer, write_len, read_buffer, read_len);
+        SENSORLIB_TRACE_END(SENSORLIB_BUS_WRITE_READ, traceRegister(write_buffer, write_len), read_len, ret);
+        return ret;
+    }
+
+    int writeThenReadBus(uint8_t *write_buffer, uint8_t write_len, uint8_t *read_buffer, uint8_t read_len)
     {
 #if defined(ARDUINO)
         if (__wire) {
@@ -340,6 +756,17 @@ protected:
             return __wire->readBytes(read_buffer, read_len) == read_len ? DEV_WIRE_NONE : DEV_WIRE_ERR;
         }
 #elif defined(ESP_PLATFORM)
+        if (__spi_device) {
+            // The written bytes make up the address phase
+            if (write_len > 8) {
+                return DEV_WIRE_ERR;
+            }
+            uint64_t addr = 0;
+            for (int i = 0; i < write_len; ++i) {
+                addr = (addr << 8) | write_buffer[i];
+            }
+            return spiTransfer(write_len * 8, addr, NULL, read_buffer, read_len);
+        }
 
 #if ((ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)) && defined(CONFIG_SENSORLIB_ESP_IDF_NEW_API))
         if (ESP_OK == i2c_master_transmit_receive(
@@ -370,6 +797,20 @@ protected:
 
     int writeBuffer(uint8_t *buf, size_t length)
     {
+        SENSORLIB_TRACE_START();
+        int ret = writeBufferBus(buf, length);
+        SENSORLIB_TRACE_END(SENSORLIB_BUS_WRITE, traceRegister(buf, length),
+                            length > __reg_addr_len ? length - __reg_addr_len : 0, ret);
+        return ret;
+    }
+
+    int writeBufferBus(uint8_t *buf, size_t length)
+    {
+#if defined(SENSORLIB_HOST)
+        if (__i2c_master_transmit) {
+            return __i2c_master_transmit(__addr, buf, length);
+        }
+#endif
 #if defined(ARDUINO)
         if (__wire) {
             __wire->beginTransmission(__addr);
@@ -378,6 +819,9 @@ protected:
             return ret == 0 ? DEV_WIRE_NONE : DEV_WIRE_ERR;
         }
 #elif defined(ESP_PLATFORM)
+        if (__spi_device) {
+            return spiTransfer(0, 0, buf, NULL, length);
+        }
 
 #if ((ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)) && defined(CONFIG_SENSORLIB_ESP_IDF_NEW_API))
         if (ESP_OK == i2c_master_transmit(
@@ -402,10 +846,41 @@ protected:
     }
 
     int writeRegister(int reg, uint8_t *buf, uint8_t length)
+    {
+        if (__batch_depth) {
+            return batchWrite(reg, buf, length);
+        }
+        return writeRegisterNow(reg, buf, length);
+    }
+
+    int writeRegisterNow(int reg, uint8_t *buf, uint8_t length)
+    {
+        SENSORLIB_TRACE_START();
+        int ret = writeRegisterBus(reg, buf, length);
+        SENSORLIB_TRACE_END(SENSORLIB_BUS_WRITE, reg, length, ret);
+        if (__reg_cache) {
+            for (int i = 0; i < length; ++i) {
+                if (ret == DEV_WIRE_NONE) {
+                    cacheRegister(reg + i, buf[i]);
+                } else {
+                    // A failed write leaves the register unknown
+                    uncacheRegister(reg + i);
+                }
+            }
+        }
+        return ret;
+    }
+
+    int writeRegisterBus(int reg, uint8_t *buf, uint8_t length)
     {
         if (__i2c_master_write) {
             return __i2c_master_write(__addr, reg, buf, length);
         }
+#if defined(SENSORLIB_HOST)
+        if (__i2c_master_transmit) {
+            return writeRegisterJoined(reg, buf, length);
+        }
+#endif
 #if defined(ARDUINO)
         if (__wire) {
             __wire->beginTransmission(__addr);
@@ -437,18 +912,53 @@ protected:
         return DEV_WIRE_ERR;
 
 #elif defined(ESP_PLATFORM)
-        uint8_t *write_buffer = (uint8_t *)malloc(sizeof(uint8_t) * (length + __reg_addr_len));
+        if (__spi_device) {
+            return spiTransfer(__reg_addr_len * 8, spiAddress(reg, false), buf, NULL, length);
+        }
+#if defined(SENSORLIB_I2C_MULTI_BUFFER)
+        i2c_master_transmit_multi_buffer_info_t parts[2];
+        parts[0].write_buffer = (uint8_t *)&reg;
+        parts[0].buffer_size = __reg_addr_len;
+        parts[1].write_buffer = buf;
+        parts[1].buffer_size = length;
+        if (ESP_OK == i2c_master_multi_buffer_transmit(__i2c_device, parts, length ? 2 : 1, -1)) {
+            return DEV_WIRE_NONE;
+        }
+        return DEV_WIRE_ERR;
+#else
+        return writeRegisterJoined(reg, buf, length);
+#endif //SENSORLIB_I2C_MULTI_BUFFER
+#else
+        return DEV_WIRE_ERR;
+#endif //ESP_PLATFORM
+    }
+
+#if defined(SENSORLIB_JOINED_WRITE)
+    int writeRegisterJoined(int reg, uint8_t *buf, uint8_t length)
+    {
+        // The address comes out of an int, never more bytes than it has
+        size_t addr_len = __reg_addr_len < sizeof(reg) ? __reg_addr_len : sizeof(reg);
+#if SENSORLIB_WRITE_BUFFER_SIZE > 0
+        if (addr_len + length <= SENSORLIB_WRITE_BUFFER_SIZE) {
+            memcpy(__write_buffer, &reg, addr_len);
+            memcpy(__write_buffer + addr_len, buf, length);
+            return writeBufferBus(__write_buffer, addr_len + length);
+        }
+#endif
+        // Still one transaction: data port registers (e.g. the BMA423 feature
+        // config) take the whole write at one address
+        uint8_t *write_buffer = (uint8_t *)malloc(sizeof(uint8_t) * (length + addr_len));
         if (!write_buffer) {
             return DEV_WIRE_ERR;
         }
-        write_buffer[0] = reg;
-        memcpy(write_buffer, &reg, __reg_addr_len);
-        memcpy(write_buffer + __reg_addr_len, buf, length);
-        int ret = writeBuffer(write_buffer, __reg_addr_len + length);
+        __write_allocations++;
+        memcpy(write_buffer, &reg, addr_len);
+        memcpy(write_buffer + addr_len, buf, length);
+        int ret = writeBufferBus(write_buffer, addr_len + length);
         free(write_buffer);
         return ret;
-#endif //ESP_PLATFORM
     }
+#endif //SENSORLIB_JOINED_WRITE
 
     //! Read method
     int readRegister(int reg)
@@ -463,6 +973,42 @@ protected:
     }
 
     int readRegister(int reg, uint8_t *buf, uint8_t length)
+    {
+        if (__batch_len && batchAffects(reg, length)) {
+            flushBatch();
+        }
+        SENSORLIB_TRACE_START();
+        int ret = readRegisterBus(reg, buf, length);
+        SENSORLIB_TRACE_END(SENSORLIB_BUS_READ, reg, length, ret);
+        if (__reg_cache && ret == DEV_WIRE_NONE) {
+            for (int i = 0; i < length; ++i) {
+                cacheRegister(reg + i, buf[i]);
+            }
+        }
+        if (__batch_depth && ret != DEV_WIRE_NONE && __batch_err == DEV_WIRE_NONE) {
+            __batch_err = ret;
+        }
+        return ret;
+    }
+
+    // Register value for a read-modify-write, from the cache when possible
+    int readRegisterCached(int reg)
+    {
+        if (__batch_len && reg >= __batch_reg && reg < __batch_reg + __batch_len) {
+            // Written earlier in the batch and not sent yet
+            return __batch_data[reg - __batch_reg];
+        }
+        if (isCacheable(reg)) {
+            if (__reg_cache[SENSORLIB_REG_CACHE_SIZE + (reg >> 3)] & _BV(reg & 7)) {
+                __reg_cache_hits++;
+                return __reg_cache[reg];
+            }
+            __reg_cache_misses++;
+        }
+        return readRegister(reg);
+    }
+
+    int readRegisterBus(int reg, uint8_t *buf, uint8_t length)
     {
         if (__i2c_master_read) {
             return __i2c_master_read(__addr, reg, buf, length);
@@ -503,6 +1049,9 @@ protected:
             return DEV_WIRE_NONE;
         }
 #elif defined(ESP_PLATFORM)
+        if (__spi_device) {
+            return spiTransfer(__reg_addr_len * 8, spiAddress(reg, true), NULL, buf, length);
+        }
 
 #if ((ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)) && defined(CONFIG_SENSORLIB_ESP_IDF_NEW_API))
         if (ESP_OK == i2c_master_transmit_receive(
@@ -532,7 +1081,7 @@ protected:
 
     bool inline clrRegisterBit(int registers, uint8_t bit)
     {
-        int val = readRegister(registers);
+        int val = readRegisterCached(registers);
         if (val == DEV_WIRE_ERR) {
             return false;
         }
@@ -541,7 +1090,7 @@ protected:
 
     bool inline setRegisterBit(int registers, uint8_t bit)
     {
-        int val = readRegister(registers);
+        int val = readRegisterCached(registers);
         if (val == DEV_WIRE_ERR) {
             return false;
         }
@@ -557,38 +1106,140 @@ protected:
         return val & _BV(bit);
     }
 
+    /*
+     * Register fields, see SensorRegField.hpp
+     */
+    // Field value, or DEV_WIRE_ERR
+    template <class Field>
+    int readField()
+    {
+        static_assert(Field::access != REG_WO, "Field is write only");
+        int val = readRegister(Field::reg);
+        if (val == DEV_WIRE_ERR) {
+            return DEV_WIRE_ERR;
+        }
+        return Field::decode(val);
+    }
+
+    template <class Field, typename T>
+    int writeField(T value)
+    {
+        return modifyFields<Field>(value);
+    }
+
+    /**
+     * @brief Set several fields of one register with a single write. The
+     *        register is read first unless the fields cover all of it, are
+     *        write only, or the register cache holds it.
+     */
+    template <class Field, class... Rest, typename... Values>
+    int modifyFields(Values... values)
+    {
+        static_assert(sizeof...(Rest) + 1 == sizeof...(Values), "One value per field");
+        static_assert(regFieldsDisjoint<Field, Rest...>(), "Fields of different registers or overlapping");
+        static_assert(regFieldsWritable<Field, Rest...>(), "Field is read only");
+        const uint8_t mask = regFieldMask<Field, Rest...>();
+        uint8_t bits = regFieldBits<Field, Rest...>(values...);
+        if (mask == 0xFF || Field::access == REG_WO) {
+            return writeRegister(Field::reg, bits);
+        }
+        return writeRegister(Field::reg, (uint8_t)~mask, bits);
+    }
+
     uint16_t inline readRegisterH8L4(uint8_t highReg, uint8_t lowReg)
     {
-        int h8 = readRegister(highReg);
-        int l4 = readRegister(lowReg);
-        if (h8 == DEV_WIRE_ERR || l4 == DEV_WIRE_ERR)return 0;
+        uint8_t h8, l4;
+        if (!readRegisterPair(highReg, lowReg, h8, l4))return 0;
         return (h8 << 4) | (l4 & 0x0F);
     }
 
     uint16_t inline readRegisterH8L5(uint8_t highReg, uint8_t lowReg)
     {
-        int h8 = readRegister(highReg);
-        int l5 = readRegister(lowReg);
-        if (h8 == DEV_WIRE_ERR || l5 == DEV_WIRE_ERR)return 0;
+        uint8_t h8, l5;
+        if (!readRegisterPair(highReg, lowReg, h8, l5))return 0;
         return (h8 << 5) | (l5 & 0x1F);
     }
 
     uint16_t inline readRegisterH6L8(uint8_t highReg, uint8_t lowReg)
     {
-        int h6 = readRegister(highReg);
-        int l8 = readRegister(lowReg);
-        if (h6 == DEV_WIRE_ERR || l8 == DEV_WIRE_ERR)return 0;
+        uint8_t h6, l8;
+        if (!readRegisterPair(highReg, lowReg, h6, l8))return 0;
         return ((h6 & 0x3F) << 8) | l8;
     }
 
     uint16_t inline readRegisterH5L8(uint8_t highReg, uint8_t lowReg)
     {
-        int h5 = readRegister(highReg);
-        int l8 = readRegister(lowReg);
-        if (h5 == DEV_WIRE_ERR || l8 == DEV_WIRE_ERR)return 0;
+        uint8_t h5, l8;
+        if (!readRegisterPair(highReg, lowReg, h5, l8))return 0;
         return ((h5 & 0x1F) << 8) | l8;
     }
 
+    // \p count values from high, low register pairs following each other
+    // from \p reg, all in one transfer
+    bool inline readRegisterH8L4Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0xFF, 4, 0x0F);
+    }
+
+    bool inline readRegisterH8L5Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0xFF, 5, 0x1F);
+    }
+
+    bool inline readRegisterH6L8Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0x3F, 8, 0xFF);
+    }
+
+    bool inline readRegisterH5L8Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0x1F, 8, 0xFF);
+    }
+
+    // Adjacent registers are read in one transfer, so the two halves of a
+    // value come from the same sample
+    bool readRegisterPair(uint8_t highReg, uint8_t lowReg, uint8_t &high, uint8_t &low)
+    {
+        uint8_t buf[2];
+        if (lowReg == highReg + 1) {
+            if (readRegister(highReg, buf, 2) != DEV_WIRE_NONE)return false;
+            high = buf[0];
+            low = buf[1];
+            return true;
+        }
+        if (highReg == lowReg + 1) {
+            if (readRegister(lowReg, buf, 2) != DEV_WIRE_NONE)return false;
+            low = buf[0];
+            high = buf[1];
+            return true;
+        }
+        int h = readRegister(highReg);
+        int l = readRegister(lowReg);
+        if (h == DEV_WIRE_ERR || l == DEV_WIRE_ERR)return false;
+        high = h;
+        low = l;
+        return true;
+    }
+
+    bool readRegisterBurst(uint8_t reg, uint16_t *values, uint8_t count,
+                           uint8_t highMask, uint8_t highShift, uint8_t lowMask)
+    {
+        uint8_t buf[32];
+        while (count) {
+            uint8_t n = count < sizeof(buf) / 2 ? count : sizeof(buf) / 2;
+            if (readRegister(reg, buf, n * 2) != DEV_WIRE_NONE) {
+                return false;
+            }
+            for (uint8_t i = 0; i < n; ++i) {
+                values[i] = ((buf[i * 2] & highMask) << highShift) | (buf[i * 2 + 1] & lowMask);
+            }
+            reg += n * 2;
+            values += n;
+            count -= n;
+        }
+        return true;
+    }
+
     void setRegAddressLength(uint8_t len)
     {
         __reg_addr_len = len;
@@ -600,6 +1251,242 @@ protected:
         __sendStop = sendStop;
     }
 
+    /**
+     * @brief Collect the register writes that follow until submitBatch().
+     *        Writes to consecutive registers go out as one transaction and
+     *        rewriting the last register of a run only updates its value.
+     * @note  Writes return DEV_WIRE_NONE once collected, submitBatch() returns
+     *        the first error of the batch. Reads of volatile registers or of
+     *        registers waiting in the batch send the collected writes first.
+     *        Batches nest, the outermost submitBatch() sends.
+     */
+    void beginBatch()
+    {
+        if (__batch_depth++ == 0) {
+            __batch_len = 0;
+            __batch_err = DEV_WIRE_NONE;
+        }
+    }
+
+    int submitBatch()
+    {
+        if (__batch_depth && --__batch_depth == 0) {
+            flushBatch();
+        }
+        return __batch_err;
+    }
+
+    int batchWrite(int reg, uint8_t *buf, uint8_t length)
+    {
+        const int end = __batch_reg + __batch_len;
+        if (__batch_len && reg >= __batch_reg && reg + length == end && !anyVolatile(reg, length)) {
+            // Only the last value of a configuration register matters
+            memcpy(__batch_data + (reg - __batch_reg), buf, length);
+            return DEV_WIRE_NONE;
+        }
+        if (__batch_len && (reg != end || __batch_len + length > SENSORLIB_BATCH_SIZE)) {
+            flushBatch();
+        }
+        if (length > SENSORLIB_BATCH_SIZE) {
+            int ret = writeRegisterNow(reg, buf, length);
+            if (ret != DEV_WIRE_NONE && __batch_err == DEV_WIRE_NONE) {
+                __batch_err = ret;
+            }
+            return ret;
+        }
+        if (!__batch_len) {
+            __batch_reg = reg;
+        }
+        memcpy(__batch_data + __batch_len, buf, length);
+        __batch_len += length;
+        return DEV_WIRE_NONE;
+    }
+
+    void flushBatch()
+    {
+        if (!__batch_len) {
+            return;
+        }
+        // batchWrite() never collects more, saying so keeps GCC from warning
+        // about the write paths that only longer writes take
+        uint8_t len = __batch_len < SENSORLIB_BATCH_SIZE ? __batch_len : SENSORLIB_BATCH_SIZE;
+        int ret = writeRegisterNow(__batch_reg, __batch_data, len);
+        if (ret != DEV_WIRE_NONE && __batch_err == DEV_WIRE_NONE) {
+            __batch_err = ret;
+        }
+        __batch_len = 0;
+    }
+
+    // Whether reading these registers has to wait for the collected writes
+    inline bool batchAffects(int reg, uint8_t length)
+    {
+        return (reg < __batch_reg + __batch_len && reg + length > __batch_reg) ||
+               anyVolatile(reg, length);
+    }
+
+    inline bool anyVolatile(int reg, uint8_t length)
+    {
+        for (int i = 0; i < length; ++i) {
+            if (thisChip().isVolatileRegisterImpl(reg + i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#if defined(ESP_PLATFORM) && !defined(ARDUINO)
+    /*
+     * ESP-IDF SPI transport
+     */
+    // Register address most significant byte first, the read mask goes on
+    // the first byte as in the Arduino SPI path
+    uint64_t spiAddress(int reg, bool read)
+    {
+        uint64_t addr = (uint32_t)reg;
+        if (__reg_addr_len < 4) {
+            addr &= (1UL << (8 * __reg_addr_len)) - 1;
+        }
+        if (read && __readMask != -1) {
+            addr |= (uint64_t)__readMask << (8 * (__reg_addr_len - 1));
+        }
+        return addr;
+    }
+
+    int spiTransfer(uint8_t addr_bits, uint64_t addr, const uint8_t *tx, uint8_t *rx, size_t length)
+    {
+        spi_transaction_ext_t t;
+        memset(&t, 0, sizeof(t));
+        t.base.flags = SPI_TRANS_VARIABLE_ADDR;
+        t.base.addr = addr;
+        t.base.length = length * 8;
+        t.base.rxlength = rx ? length * 8 : 0;
+        t.base.tx_buffer = tx;
+        t.base.rx_buffer = rx;
+        t.address_bits = addr_bits;
+        esp_err_t err;
+        if (length <= SENSORLIB_SPI_POLLING_MAX) {
+            err = spi_device_polling_transmit(__spi_device, &t.base);
+        } else {
+            err = spi_device_transmit(__spi_device, &t.base);
+        }
+        return err == ESP_OK ? DEV_WIRE_NONE : DEV_WIRE_ERR;
+    }
+#endif
+
+    /*
+     * Asynchronous transfers
+     */
+#if defined(SENSORLIB_I2C_ASYNC)
+    // Transfers of a device complete in order, so the slots form a ring
+    // filled by the task and emptied by the interrupt. The 8 bit indices wrap
+    // in step with the ring because the depth is a power of two.
+    SensorAsyncSlot_t *asyncSlot(async_done_fptr_t done, void *user_data)
+    {
+        if (getAsyncPending() >= SENSORLIB_ASYNC_DEPTH) {
+            return NULL;
+        }
+        SensorAsyncSlot_t *slot = &__async_slots[__async_head % SENSORLIB_ASYNC_DEPTH];
+        slot->done = done;
+        slot->user_data = user_data;
+        // Claimed before the transfer starts, it may complete at once
+        __async_head++;
+        return slot;
+    }
+
+    static bool IRAM_ATTR asyncDone(i2c_master_dev_handle_t dev, const i2c_master_event_data_t *edata, void *arg)
+    {
+        SensorCommon *self = (SensorCommon *)arg;
+        SensorAsyncSlot_t *slot = &self->__async_slots[self->__async_tail % SENSORLIB_ASYNC_DEPTH];
+        async_done_fptr_t done = slot->done;
+        void *user_data = slot->user_data;
+        self->__async_tail++;
+        if (done) {
+            done(edata->event == I2C_EVENT_DONE ? DEV_WIRE_NONE : DEV_WIRE_ERR, user_data);
+        }
+        return false;
+    }
+#endif
+
+    /*
+     * Bus trace
+     */
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+    // Register address at the start of a raw write, most significant byte first
+    int traceRegister(const uint8_t *buf, size_t length)
+    {
+        int reg = 0;
+        for (size_t i = 0; i < __reg_addr_len && i < length; ++i) {
+            reg = (reg << 8) | buf[i];
+        }
+        return reg;
+    }
+
+    void traceBus(uint8_t op, int reg, size_t length, int ret, uint32_t start)
+    {
+        uint32_t us = SENSORLIB_MICROS() - start;
+        int bucket = us ? 31 - __builtin_clz(us) : 0;
+        if (bucket >= SENSORLIB_BUS_TRACE_BUCKETS) {
+            bucket = SENSORLIB_BUS_TRACE_BUCKETS - 1;
+        }
+        SensorBusStats_t &s = __bus_stats;
+        s.transfers[op]++;
+        if (ret < 0) {
+            s.errors++;
+        } else if (op == SENSORLIB_BUS_WRITE) {
+            s.bytes_written += length;
+        } else {
+            s.bytes_read += length;
+        }
+        s.total_us += us;
+        if (us > s.max_us) {
+            s.max_us = us;
+        }
+        s.histogram[bucket]++;
+#if SENSORLIB_BUS_TRACE_DEPTH > 0
+        SensorBusTraceEntry_t &e = __trace_ring[__trace_count % SENSORLIB_BUS_TRACE_DEPTH];
+        e.start_us = start;
+        e.duration_us = us;
+        e.reg = (uint16_t)reg;
+        e.op = op;
+        e.length = length > 0xFF ? 0xFF : (uint8_t)length;
+        e.result = ret < 0 ? (int8_t)ret : 0;
+#endif
+        __trace_count++;
+    }
+#endif
+
+    /*
+     * Shadow register cache
+     */
+    inline bool isCacheable(int reg)
+    {
+        return __reg_cache && reg >= 0 && reg < SENSORLIB_REG_CACHE_SIZE &&
+               !thisChip().isVolatileRegisterImpl(reg);
+    }
+
+    inline void cacheRegister(int reg, uint8_t val)
+    {
+        if (isCacheable(reg)) {
+            __reg_cache[reg] = val;
+            __reg_cache[SENSORLIB_REG_CACHE_SIZE + (reg >> 3)] |= _BV(reg & 7);
+        }
+    }
+
+    inline void uncacheRegister(int reg)
+    {
+        if (isCacheable(reg)) {
+            __reg_cache[SENSORLIB_REG_CACHE_SIZE + (reg >> 3)] &= ~_BV(reg & 7);
+        }
+    }
+
+    // Drivers override this with the registers the chip may change by itself,
+    // status, data, FIFO and command registers. By default nothing is cached.
+    bool isVolatileRegisterImpl(int reg)
+    {
+        (void)reg;
+        return true;
+    }
+
 
 
     /*
@@ -675,10 +1562,20 @@ protected:
     i2c_master_bus_handle_t  bus_handle;
     i2c_master_dev_handle_t  __i2c_device;
     i2c_device_config_t     __i2c_dev_conf;
+    i2c_master_dev_handle_t  __i2c_async_device = NULL;
+    SensorAsyncSlot_t       __async_slots[SENSORLIB_ASYNC_DEPTH];
 #endif //ESP_IDF_VERSION
-
+    spi_device_handle_t     __spi_device = NULL;
+    uint32_t                __freq = SENSORLIB_SPI_MASTER_SPEED;
+    uint8_t                 __dataMode = 0;
 #endif //ESP_PLATFORM
 
+#if SENSORLIB_WRITE_BUFFER_SIZE > 0 && defined(SENSORLIB_JOINED_WRITE)
+    // Register address and data of the write in progress, a device is only
+    // used from one task at a time
+    uint8_t             __write_buffer[SENSORLIB_WRITE_BUFFER_SIZE];
+#endif
+
     int                 __readMask              = -1;
     int                 __sda                   = -1;
     int                 __scl                   = -1;
@@ -691,9 +1588,30 @@ protected:
     uint8_t             __reg_addr_len          = 1;
     iic_fptr_t          __i2c_master_read       = NULL;
     iic_fptr_t          __i2c_master_write      = NULL;
+#if defined(SENSORLIB_HOST)
+    iic_transmit_fptr_t __i2c_master_transmit   = NULL;
+#endif
     gpio_write_fptr_t   __set_gpio_level        = NULL;
     gpio_read_fptr_t    __get_gpio_level        = NULL;
     gpio_mode_fptr_t    __set_gpio_mode         = NULL;
     delay_ms_fptr_t     __delay_ms              = NULL;
+    uint32_t            __write_allocations     = 0;
+    uint8_t             *__reg_cache            = NULL;
+    uint32_t            __reg_cache_hits        = 0;
+    uint32_t            __reg_cache_misses      = 0;
+    uint8_t             __batch_depth           = 0;
+    uint8_t             __batch_len             = 0;
+    int                 __batch_reg             = 0;
+    int                 __batch_err             = DEV_WIRE_NONE;
+    uint8_t             __batch_data[SENSORLIB_BATCH_SIZE];
+    volatile uint8_t    __async_head            = 0;
+    volatile uint8_t    __async_tail            = 0;
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+    SensorBusStats_t    __bus_stats             = {};
+    uint32_t            __trace_count           = 0;
+#if SENSORLIB_BUS_TRACE_DEPTH > 0
+    SensorBusTraceEntry_t __trace_ring[SENSORLIB_BUS_TRACE_DEPTH];
+#endif
+#endif
 
 };
@@ -45,6 +45,7 @@
 #else
 #include "driver/i2c.h"
 #endif  //ESP_IDF_VERSION
+#include "driver/spi_master.h"
 #else
 #include <stdint.h>
 #include <stdlib.h>
@@ -85,6 +86,43 @@
 #define SENSORLIB_I2C_MASTER_TIMEOUT_MS       1000
 #define SENSORLIB_I2C_MASTER_SEEED            400000
 
+// SPI clock of begin(spi_host_device_t, ...), setSpiSetting() changes it
+#ifndef SENSORLIB_SPI_MASTER_SPEED
+#define SENSORLIB_SPI_MASTER_SPEED            10000000
+#endif
+
+// SPI transfers up to this many data bytes busy-wait for the result, longer
+// ones are queued and the task sleeps until the DMA transfer is done
+#ifndef SENSORLIB_SPI_POLLING_MAX
+#define SENSORLIB_SPI_POLLING_MAX             32
+#endif
+
+#if ((ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)) && defined(CONFIG_SENSORLIB_ESP_IDF_NEW_API))
+// Register transfers can complete through the I2C master trans queue
+#define SENSORLIB_I2C_ASYNC
+#endif
+
+#if ((ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,4,0)) && defined(CONFIG_SENSORLIB_ESP_IDF_NEW_API))
+// Register address and data go out as two buffers of one transaction
+#define SENSORLIB_I2C_MULTI_BUFFER
+#endif
+
+#if defined(CONFIG_SENSORLIB_WRITE_BUFFER_SIZE) && !defined(SENSORLIB_WRITE_BUFFER_SIZE)
+#define SENSORLIB_WRITE_BUFFER_SIZE           CONFIG_SENSORLIB_WRITE_BUFFER_SIZE
+#endif
+
+#if defined(CONFIG_SENSORLIB_ENABLE_BUS_TRACE) && !defined(SENSORLIB_ENABLE_BUS_TRACE)
+#define SENSORLIB_ENABLE_BUS_TRACE
+#endif
+
+#if defined(CONFIG_SENSORLIB_BUS_TRACE_DEPTH) && !defined(SENSORLIB_BUS_TRACE_DEPTH)
+#define SENSORLIB_BUS_TRACE_DEPTH             CONFIG_SENSORLIB_BUS_TRACE_DEPTH
+#endif
+
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+#include "esp_timer.h"
+#endif
+
 #endif
 
 enum SensorLibInterface {
@@ -120,10 +158,65 @@ typedef struct __SensorLibPins {
 
 
 
+// Per device register write buffer, register address included. 64 data
+// bytes cover the register writes of the bundled drivers, longer ones are
+// allocated for the time of the transfer.
+#ifndef SENSORLIB_WRITE_BUFFER_SIZE
+#define SENSORLIB_WRITE_BUFFER_SIZE     66
+#endif
+
+// Register writes go out as one buffer of address and data, assembled in
+// the write buffer or an allocation. The host builds it for the simulator.
+#if (defined(ESP_PLATFORM) && !defined(SENSORLIB_I2C_MULTI_BUFFER)) || defined(SENSORLIB_HOST)
+#define SENSORLIB_JOINED_WRITE
+#endif
+
+// Data bytes a write batch collects for consecutive registers
+#ifndef SENSORLIB_BATCH_SIZE
+#define SENSORLIB_BATCH_SIZE            16
+#endif
+
+// Asynchronous transfers a device keeps in flight, at most the
+// trans_queue_depth of the I2C bus
+#ifndef SENSORLIB_ASYNC_DEPTH
+#define SENSORLIB_ASYNC_DEPTH           4
+#endif
+#if SENSORLIB_ASYNC_DEPTH < 1 || SENSORLIB_ASYNC_DEPTH > 128 || (SENSORLIB_ASYNC_DEPTH & (SENSORLIB_ASYNC_DEPTH - 1))
+#error "SENSORLIB_ASYNC_DEPTH must be a power of two from 1 to 128"
+#endif
+
+// Register address and data of one asynchronous write
+#ifndef SENSORLIB_ASYNC_WRITE_SIZE
+#define SENSORLIB_ASYNC_WRITE_SIZE      16
+#endif
+
+// Registers covered by the shadow register cache, one byte addresses only
+#define SENSORLIB_REG_CACHE_SIZE        256
+
+// Recent transfers each device keeps for dumpBusTrace(), 0 keeps the
+// counters and the latency histogram only
+#ifndef SENSORLIB_BUS_TRACE_DEPTH
+#define SENSORLIB_BUS_TRACE_DEPTH       16
+#endif
+
+// Latency histogram buckets, powers of two microseconds
+#define SENSORLIB_BUS_TRACE_BUCKETS     16
+
+// Microsecond clock of the bus trace. esp_timer is used directly on ESP-IDF,
+// the micros() of platform/esp_arduino does not count microseconds.
+#if defined(ARDUINO) || defined(SENSORLIB_HOST)
+#define SENSORLIB_MICROS()              ((uint32_t)micros())
+#elif defined(ESP_PLATFORM)
+#define SENSORLIB_MICROS()              ((uint32_t)esp_timer_get_time())
+#else
+#define SENSORLIB_MICROS()              (0UL)
+#endif
+
 #define SENSOR_PIN_NONE     (-1)
 #define DEV_WIRE_NONE       (0)
 #define DEV_WIRE_ERR        (-1)
 #define DEV_WIRE_TIMEOUT    (-2)
+#define DEV_WIRE_BUSY       (-3)
 
 
 
@@ -229,3 +322,7 @@ typedef struct __SensorLibPins {
 #include "platform/esp_arduino.h"
 
 #endif
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+#include "platform/host_platform.h"
+#endif
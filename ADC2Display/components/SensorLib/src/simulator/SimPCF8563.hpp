@@ -0,0 +1,191 @@
+/**
+ * @file      SimPCF8563.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * PCF8563 model: the BCD calendar running from the virtual clock with the
+ * voltage low and century bits, the minute alarm and the countdown timer
+ * with their flags. The calendar counts across month and year ends, leap
+ * years included; CLKOUT is only stored.
+ */
+#pragma once
+
+#include "SensorSimulator.hpp"
+#include "../REG/PCF8563Constants.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+class SimPCF8563 : public SensorSimChip
+{
+public:
+    SimPCF8563(uint8_t addr = PCF8563_SLAVE_ADDRESS) : SensorSimChip(addr)
+    {
+        // Power on: 2000-01-01 00:00:00 with the clock integrity flag set
+        __regs[PCF8563_SEC_REG] = PCF8563_VOL_LOW_MASK;
+        __regs[PCF8563_DAY_REG] = 0x01;
+        __regs[PCF8563_MONTH_REG] = 0x01;
+        for (int i = 0; i < 4; ++i) {
+            __regs[PCF8563_ALRM_MIN_REG + i] = PCF8563_ALARM_ENABLE;
+        }
+        __regs[PCF8563_SQW_REG] = PCF8563_CLK_ENABLE;
+        __regs[PCF8563_TIMER1_REG] = PCF8563_TIMER_CTL_MASK;
+    }
+
+    // Interrupt output, active low
+    bool interruptLevel() const
+    {
+        uint8_t stat2 = __regs[PCF8563_STAT2_REG];
+        bool alarm = (stat2 & PCF8563_ALARM_AF) && (stat2 & PCF8563_ALARM_AIE);
+        bool timer = (stat2 & PCF8563_TIMER_TF) && (stat2 & PCF8563_TIMER_TIE);
+        return !(alarm || timer);
+    }
+
+    void step(uint64_t now_us)
+    {
+        // STOP in control/status 1 halts the prescaler
+        if (__regs[PCF8563_STAT1_REG] & 0x20) {
+            __last_us = now_us;
+            return;
+        }
+        while (now_us - __last_us >= 1000000ULL) {
+            __last_us += 1000000ULL;
+            tick();
+        }
+        stepTimer(now_us);
+    }
+
+protected:
+    void startTransfer(uint8_t reg, bool write)
+    {
+        (void)reg;
+        (void)write;
+        __time_written = false;
+    }
+
+    void endTransfer(bool write)
+    {
+        // Setting the time restarts the seconds prescaler
+        if (write && __time_written) {
+            __last_us = hostClockUs();
+        }
+    }
+
+    void writeByte(uint8_t reg, uint8_t val)
+    {
+        if (reg >= PCF8563_SEC_REG && reg <= PCF8563_YEAR_REG) {
+            __time_written = true;
+        }
+        if (reg == PCF8563_TIMER2_REG) {
+            __timer_reload = val;
+        }
+        if (reg == PCF8563_TIMER1_REG && ((val & ~__regs[reg]) & PCF8563_TIMER_TE)) {
+            __timer_last_us = hostClockUs();
+        }
+        __regs[reg] = val;
+    }
+
+    // The register address wraps after the last timer register
+    uint8_t nextRegister(uint8_t reg)
+    {
+        return (reg + 1) & 0x0F;
+    }
+
+private:
+    static uint8_t bcd2dec(uint8_t val)
+    {
+        return (val >> 4) * 10 + (val & 0x0F);
+    }
+
+    static uint8_t dec2bcd(uint8_t val)
+    {
+        return ((val / 10) << 4) | (val % 10);
+    }
+
+    uint8_t daysInMonth(uint8_t month, uint16_t year) const
+    {
+        static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return (month == 2 && leap) ? 29 : days[(month - 1) % 12];
+    }
+
+    // Field value, carry into the next field when it wraps
+    bool count(uint8_t reg, uint8_t mask, uint8_t wrap, uint8_t first)
+    {
+        uint8_t keep = __regs[reg] & ~mask;
+        uint8_t val = bcd2dec(__regs[reg] & mask) + 1;
+        bool carry = val >= wrap;
+        __regs[reg] = keep | dec2bcd(carry ? first : val);
+        return carry;
+    }
+
+    void tick()
+    {
+        if (!count(PCF8563_SEC_REG, 0x7F, 60, 0)) {
+            return;
+        }
+        if (count(PCF8563_MIN_REG, PCF8563_MINUTES_MASK, 60, 0) &&
+                count(PCF8563_HR_REG, PCF8563_HOUR_MASK, 24, 0)) {
+            uint8_t &wday = __regs[PCF8563_WEEKDAY_REG];
+            wday = (wday & ~PCF8563_WEEKDAY_MASK) | (((wday & PCF8563_WEEKDAY_MASK) + 1) % 7);
+            uint8_t month = bcd2dec(__regs[PCF8563_MONTH_REG] & PCF8563_MONTH_MASK);
+            // Century bit set is 1900 for the driver
+            uint16_t year = bcd2dec(__regs[PCF8563_YEAR_REG]) +
+                            ((__regs[PCF8563_MONTH_REG] & PCF8563_CENTURY_MASK) ? 1900 : 2000);
+            if (count(PCF8563_DAY_REG, PCF8563_DAY_MASK, daysInMonth(month, year) + 1, 1) &&
+                    count(PCF8563_MONTH_REG, PCF8563_MONTH_MASK, 13, 1) &&
+                    count(PCF8563_YEAR_REG, 0xFF, 100, 0)) {
+                __regs[PCF8563_MONTH_REG] ^= PCF8563_CENTURY_MASK;
+            }
+        }
+        checkAlarm();
+    }
+
+    // Every field with its enable bit clear has to match
+    void checkAlarm()
+    {
+        static const uint8_t field[4] = {PCF8563_MIN_REG, PCF8563_HR_REG, PCF8563_DAY_REG, PCF8563_WEEKDAY_REG};
+        static const uint8_t mask[4] = {PCF8563_MINUTES_MASK, PCF8563_HOUR_MASK, PCF8563_DAY_MASK, PCF8563_WEEKDAY_MASK};
+        bool armed = false;
+        for (int i = 0; i < 4; ++i) {
+            uint8_t alarm = __regs[PCF8563_ALRM_MIN_REG + i];
+            if (alarm & PCF8563_ALARM_ENABLE) {
+                continue;
+            }
+            if ((alarm & mask[i]) != (__regs[field[i]] & mask[i])) {
+                return;
+            }
+            armed = true;
+        }
+        if (armed) {
+            __regs[PCF8563_STAT2_REG] |= PCF8563_ALARM_AF;
+        }
+    }
+
+    void stepTimer(uint64_t now_us)
+    {
+        static const uint64_t period[4] = {244, 15625, 1000000ULL, 60000000ULL};
+        uint8_t ctrl = __regs[PCF8563_TIMER1_REG];
+        if (!(ctrl & PCF8563_TIMER_TE)) {
+            __timer_last_us = now_us;
+            return;
+        }
+        uint64_t p = period[ctrl & PCF8563_TIMER_TD10];
+        while (now_us - __timer_last_us >= p) {
+            __timer_last_us += p;
+            uint8_t &val = __regs[PCF8563_TIMER2_REG];
+            if (val > 1) {
+                val--;
+            } else {
+                val = __timer_reload;
+                __regs[PCF8563_STAT2_REG] |= PCF8563_TIMER_TF;
+            }
+        }
+    }
+
+    uint64_t    __last_us = 0;
+    uint64_t    __timer_last_us = 0;
+    uint8_t     __timer_reload = 0;
+    bool        __time_written = false;
+};
+
+#endif
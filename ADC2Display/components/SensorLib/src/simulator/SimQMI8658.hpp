@@ -0,0 +1,294 @@
+/**
+ * @file      SimQMI8658.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * QMI8658 model: reset, the CTRL9 command handshake, accelerometer and
+ * gyroscope sampling at the configured rates and ranges, data ready flags,
+ * timestamp and the FIFO in bypass, FIFO and stream modes. Motion comes from
+ * two traces, acceleration in g and angular rate in dps. Tap, pedometer and
+ * motion engines are not modelled, their commands only complete.
+ */
+#pragma once
+
+#include "SensorSimulator.hpp"
+#include "../REG/QMI8658Constants.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+class SimQMI8658 : public SensorSimChip
+{
+public:
+    SimQMI8658(uint8_t addr = QMI8658_L_SLAVE_ADDRESS) : SensorSimChip(addr), accel(3), gyro(3)
+    {
+        reset();
+        const float gravity[3] = {0, 0, 1.0f};
+        accel.setConstant(gravity);
+    }
+
+    void reset()
+    {
+        memset(__regs, 0, sizeof(__regs));
+        __regs[QMI8658_REG_WHOAMI] = QMI8658_REG_WHOAMI_DEFAULT;
+        __regs[QMI8658_REG_REVISION] = 0x7C;
+        __regs[QMI8658_REG_RST_RESULT] = QMI8658_REG_RST_RESULT_VAL;
+        __fifo.clear();
+        __fifo_overflow = false;
+        __timestamp = 0;
+        setTemperature(__temperature);
+    }
+
+    void setTemperature(float celsius)
+    {
+        __temperature = celsius;
+        int16_t raw = (int16_t)(celsius * 256.0f);
+        putLE16(QMI8658_REG_TEMPEARTURE_L, raw);
+    }
+
+    // Acceleration in g, angular rate in dps
+    SensorSimTrace accel;
+    SensorSimTrace gyro;
+
+    void step(uint64_t now_us)
+    {
+        __now = now_us;
+        uint8_t en = __regs[QMI8658_REG_CTRL7] & 0x03;
+        if (!en) {
+            return;
+        }
+        // With both sensors on the accelerometer runs at the gyroscope rate
+        uint32_t period = (en & 0x02) ? gyroPeriod() : accelPeriod();
+        if (!period) {
+            return;
+        }
+        uint64_t missed = now_us >= __next_us ? (now_us - __next_us) / period : 0;
+        uint32_t keep = fifoCapacity() + 1;
+        if (missed > keep) {
+            __next_us += (missed - keep) * period;
+            __fifo_overflow = __fifo_overflow || fifoMode() != 0;
+        }
+        while (__next_us <= now_us) {
+            sample(__next_us, en);
+            __next_us += period;
+        }
+    }
+
+protected:
+    uint8_t readByte(uint8_t reg)
+    {
+        switch (reg) {
+        case QMI8658_REG_FIFOCOUNT:
+            return (uint8_t)(__fifo.size() / 2);
+        case QMI8658_REG_FIFOSTATUS:
+            return fifoStatus();
+        case QMI8658_REG_FIFODATA: {
+            if (!(__regs[QMI8658_REG_FIFOCTRL] & 0x80) || __fifo.empty()) {
+                return 0;
+            }
+            uint8_t val = __fifo.front();
+            __fifo.erase(__fifo.begin());
+            return val;
+        }
+        // Reading the last byte of a sample hands it to the host
+        case QMI8658_REG_AZ_H:
+            __regs[QMI8658_REG_STATUS0] &= ~0x01;
+            __regs[QMI8658_REG_STATUSINT] &= ~0x03;
+            return __regs[reg];
+        case QMI8658_REG_GZ_H:
+            __regs[QMI8658_REG_STATUS0] &= ~0x02;
+            __regs[QMI8658_REG_STATUSINT] &= ~0x03;
+            return __regs[reg];
+        case QMI8658_REG_STATUS1: {
+            uint8_t val = __regs[reg];
+            __regs[reg] = 0;
+            return val;
+        }
+        default:
+            return __regs[reg];
+        }
+    }
+
+    void writeByte(uint8_t reg, uint8_t val)
+    {
+        switch (reg) {
+        case QMI8658_REG_RESET:
+            if (val == QMI8658_REG_RESET_DEFAULT) {
+                reset();
+            }
+            break;
+        case QMI8658_REG_CTRL9:
+            command(val);
+            break;
+        case QMI8658_REG_CTRL7: {
+            uint8_t started = (val & ~__regs[reg]) & 0x03;
+            __regs[reg] = val;
+            if (started) {
+                uint32_t period = (val & 0x02) ? gyroPeriod() : accelPeriod();
+                __next_us = __now + period;
+            }
+            break;
+        }
+        case QMI8658_REG_FIFOCTRL:
+            // Writing the mode again also ends FIFO read mode
+            __regs[reg] = val & 0x0F;
+            break;
+        case QMI8658_REG_WHOAMI:
+        case QMI8658_REG_REVISION:
+        case QMI8658_REG_FIFOCOUNT:
+        case QMI8658_REG_FIFOSTATUS:
+        case QMI8658_REG_STATUSINT:
+        case QMI8658_REG_STATUS0:
+            break;
+        default:
+            __regs[reg] = val;
+            break;
+        }
+    }
+
+    // FIFODATA is a port, everything else increments when CTRL1 asks for it
+    uint8_t nextRegister(uint8_t reg)
+    {
+        if (reg == QMI8658_REG_FIFODATA || !(__regs[QMI8658_REG_CTRL1] & 0x40)) {
+            return reg;
+        }
+        return reg + 1;
+    }
+
+private:
+    void command(uint8_t cmd)
+    {
+        if (cmd == 0x00) {
+            __regs[QMI8658_REG_STATUSINT] &= ~0x80;
+            return;
+        }
+        switch (cmd) {
+        case 0x04:  // RST_FIFO
+            __fifo.clear();
+            __fifo_overflow = false;
+            __regs[QMI8658_REG_FIFOCTRL] &= ~0x80;
+            break;
+        case 0x05:  // REQ_FIFO
+            __regs[QMI8658_REG_FIFOCTRL] |= 0x80;
+            break;
+        case 0x0F:  // RESET_PEDOMETER
+            __regs[QMI8658_REG_PEDO_L] = __regs[QMI8658_REG_PEDO_M] = __regs[QMI8658_REG_PEDO_H] = 0;
+            break;
+        case 0x10: { // COPY_USID
+            const uint8_t fw[3] = {0x02, 0x01, 0x00};
+            const uint8_t usid[6] = {0x53, 0x49, 0x4D, 0x38, 0x36, 0x35};
+            memcpy(&__regs[QMI8658_REG_DQW_L], fw, sizeof(fw));
+            memcpy(&__regs[QMI8658_REG_DVX_L], usid, sizeof(usid));
+            break;
+        }
+        default:
+            break;
+        }
+        __regs[QMI8658_REG_STATUSINT] |= 0x80;
+    }
+
+    uint32_t accelPeriod() const
+    {
+        static const float odr[16] = {8000, 4000, 2000, 1000, 500, 250, 125, 62.5f, 31.25f,
+                                      0, 0, 0, 128, 21, 11, 3
+                                     };
+        float hz = odr[__regs[QMI8658_REG_CTRL2] & 0x0F];
+        return hz > 0 ? (uint32_t)(1000000.0f / hz) : 0;
+    }
+
+    uint32_t gyroPeriod() const
+    {
+        uint8_t code = __regs[QMI8658_REG_CTRL3] & 0x0F;
+        if (code > 8) {
+            return 0;
+        }
+        return (uint32_t)(1000000.0f / (7174.4f / (1 << code)));
+    }
+
+    uint8_t fifoMode() const
+    {
+        return __regs[QMI8658_REG_FIFOCTRL] & 0x03;
+    }
+
+    uint32_t fifoCapacity() const
+    {
+        return 16U << ((__regs[QMI8658_REG_FIFOCTRL] >> 2) & 0x03);
+    }
+
+    uint8_t fifoStatus() const
+    {
+        uint8_t en = __regs[QMI8658_REG_CTRL7] & 0x03;
+        uint32_t frame = (en == 0x03) ? 12 : 6;
+        uint32_t samples = __fifo.size() / frame;
+        uint8_t wmk = __regs[QMI8658_REG_FIFOWMKTH];
+        uint8_t val = (uint8_t)(((__fifo.size() / 2) >> 8) & 0x03);
+        if (!__fifo.empty()) {
+            val |= 0x10;
+        }
+        if (__fifo_overflow) {
+            val |= 0x20;
+        }
+        if (wmk && samples >= wmk) {
+            val |= 0x40;
+        }
+        if (samples >= fifoCapacity()) {
+            val |= 0x80;
+        }
+        return val;
+    }
+
+    void sample(uint64_t t_us, uint8_t en)
+    {
+        float v[3];
+        uint8_t frame[12];
+        uint8_t len = 0;
+        if (en & 0x01) {
+            float lsb = 32768.0f / (float)(2 << ((__regs[QMI8658_REG_CTRL2] >> 4) & 0x07));
+            accel.sample(t_us, v);
+            for (int i = 0; i < 3; ++i) {
+                putLE16(QMI8658_REG_AX_L + i * 2, saturate(v[i] * lsb));
+            }
+            memcpy(frame, &__regs[QMI8658_REG_AX_L], 6);
+            len = 6;
+            __regs[QMI8658_REG_STATUS0] |= 0x01;
+        }
+        if (en & 0x02) {
+            float lsb = 32768.0f / (float)(16 << ((__regs[QMI8658_REG_CTRL3] >> 4) & 0x07));
+            gyro.sample(t_us, v);
+            for (int i = 0; i < 3; ++i) {
+                putLE16(QMI8658_REG_GX_L + i * 2, saturate(v[i] * lsb));
+            }
+            memcpy(frame + len, &__regs[QMI8658_REG_GX_L], 6);
+            len += 6;
+            __regs[QMI8658_REG_STATUS0] |= 0x02;
+        }
+        // Available, and locked until read in sync sample mode
+        __regs[QMI8658_REG_STATUSINT] |= (__regs[QMI8658_REG_CTRL7] & 0x80) ? 0x03 : 0x01;
+
+        __timestamp = (__timestamp + 1) & 0xFFFFFF;
+        __regs[QMI8658_REG_TIMESTAMP_L] = (uint8_t)__timestamp;
+        __regs[QMI8658_REG_TIMESTAMP_M] = (uint8_t)(__timestamp >> 8);
+        __regs[QMI8658_REG_TIMESTAMP_H] = (uint8_t)(__timestamp >> 16);
+
+        // The FIFO takes no samples while the host reads it out
+        if (!fifoMode() || (__regs[QMI8658_REG_FIFOCTRL] & 0x80)) {
+            return;
+        }
+        if (__fifo.size() / len >= fifoCapacity()) {
+            __fifo_overflow = true;
+            if (fifoMode() == 1) {
+                return;
+            }
+            __fifo.erase(__fifo.begin(), __fifo.begin() + len);
+        }
+        __fifo.insert(__fifo.end(), frame, frame + len);
+    }
+
+    uint64_t                __now = 0;
+    uint64_t                __next_us = 0;
+    uint32_t                __timestamp = 0;
+    float                   __temperature = 25.0f;
+    bool                    __fifo_overflow = false;
+    std::vector<uint8_t>    __fifo;
+};
+
+#endif
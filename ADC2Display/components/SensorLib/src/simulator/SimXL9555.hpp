@@ -0,0 +1,91 @@
+/**
+ * @file      SimXL9555.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * XL9555 model: two 8 bit ports with output, polarity inversion and
+ * configuration registers. Pins configured as inputs follow the levels set
+ * from the test, outputs drive the pin from the output register. A change on
+ * an input pulls the interrupt line low until the input port is read.
+ */
+#pragma once
+
+#include "SensorSimulator.hpp"
+#include "../REG/XL9555Constants.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+class SimXL9555 : public SensorSimChip
+{
+public:
+    SimXL9555(uint8_t addr = XL9555_SLAVE_ADDRESS0) : SensorSimChip(addr)
+    {
+        // All pins are inputs with the outputs latched high after power on
+        __regs[XL9555_CTRL_OUTP0] = __regs[XL9555_CTRL_OUTP1] = 0xFF;
+        __regs[XL9555_CTRL_CFG0] = __regs[XL9555_CTRL_CFG1] = 0xFF;
+        __input_seen = pins();
+    }
+
+    // Level an external circuit drives on an input pin, IO0 to IO15
+    void setInput(uint8_t pin, bool level)
+    {
+        if (pin < 16) {
+            __external = level ? (__external | (1U << pin)) : (__external & ~(1U << pin));
+        }
+    }
+
+    // Level on the pin, either driven by the port or from setInput()
+    bool getPin(uint8_t pin) const
+    {
+        return pin < 16 && (pins() >> pin) & 0x01;
+    }
+
+    // Interrupt output, active low
+    bool interruptLevel() const
+    {
+        return ((pins() ^ __input_seen) & config()) == 0;
+    }
+
+protected:
+    uint8_t readByte(uint8_t reg)
+    {
+        if (reg == XL9555_CTRL_INP0 || reg == XL9555_CTRL_INP1) {
+            uint8_t shift = reg == XL9555_CTRL_INP0 ? 0 : 8;
+            uint16_t levels = pins();
+            // Reading a port acknowledges the changes seen on it
+            __input_seen = (__input_seen & ~(0xFFU << shift)) | (levels & (0xFFU << shift));
+            return (uint8_t)(levels >> shift) ^ __regs[XL9555_CTRL_PIP0 + (shift ? 1 : 0)];
+        }
+        return __regs[reg & 0x07];
+    }
+
+    void writeByte(uint8_t reg, uint8_t val)
+    {
+        if (reg != XL9555_CTRL_INP0 && reg != XL9555_CTRL_INP1) {
+            __regs[reg & 0x07] = val;
+        }
+    }
+
+    // Register pairs, the address toggles between the two ports
+    uint8_t nextRegister(uint8_t reg)
+    {
+        return reg ^ 0x01;
+    }
+
+private:
+    uint16_t config() const
+    {
+        return __regs[XL9555_CTRL_CFG0] | ((uint16_t)__regs[XL9555_CTRL_CFG1] << 8);
+    }
+
+    uint16_t pins() const
+    {
+        uint16_t outputs = __regs[XL9555_CTRL_OUTP0] | ((uint16_t)__regs[XL9555_CTRL_OUTP1] << 8);
+        return (__external & config()) | (outputs & ~config());
+    }
+
+    uint16_t    __external = 0xFFFF;
+    uint16_t    __input_seen = 0;
+};
+
+#endif
@@ -401,36 +401,98 @@ public:
 
     uint16_t inline readRegisterH8L4(uint8_t highReg, uint8_t lowReg)
     {
-        int h8 = readRegister(highReg);
-        int l4 = readRegister(lowReg);
-        if (h8 == -1 || l4 == -1)return 0;
+        uint8_t h8, l4;
+        if (!readRegisterPair(highReg, lowReg, h8, l4))return 0;
         return (h8 << 4) | (l4 & 0x0F);
     }
 
     uint16_t inline readRegisterH8L5(uint8_t highReg, uint8_t lowReg)
     {
-        int h8 = readRegister(highReg);
-        int l5 = readRegister(lowReg);
-        if (h8 == -1 || l5 == -1)return 0;
+        uint8_t h8, l5;
+        if (!readRegisterPair(highReg, lowReg, h8, l5))return 0;
         return (h8 << 5) | (l5 & 0x1F);
     }
 
     uint16_t inline readRegisterH6L8(uint8_t highReg, uint8_t lowReg)
     {
-        int h6 = readRegister(highReg);
-        int l8 = readRegister(lowReg);
-        if (h6 == -1 || l8 == -1)return 0;
+        uint8_t h6, l8;
+        if (!readRegisterPair(highReg, lowReg, h6, l8))return 0;
         return ((h6 & 0x3F) << 8) | l8;
     }
 
     uint16_t inline readRegisterH5L8(uint8_t highReg, uint8_t lowReg)
     {
-        int h5 = readRegister(highReg);
-        int l8 = readRegister(lowReg);
-        if (h5 == -1 || l8 == -1)return 0;
+        uint8_t h5, l8;
+        if (!readRegisterPair(highReg, lowReg, h5, l8))return 0;
         return ((h5 & 0x1F) << 8) | l8;
     }
 
+    // \p count values from high, low register pairs following each other
+    // from \p reg, all in one transfer
+    bool inline readRegisterH8L4Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0xFF, 4, 0x0F);
+    }
+
+    bool inline readRegisterH8L5Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0xFF, 5, 0x1F);
+    }
+
+    bool inline readRegisterH6L8Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0x3F, 8, 0xFF);
+    }
+
+    bool inline readRegisterH5L8Burst(uint8_t reg, uint16_t *values, uint8_t count)
+    {
+        return readRegisterBurst(reg, values, count, 0x1F, 8, 0xFF);
+    }
+
+    // Adjacent registers are read in one transfer, so the two halves of a
+    // value come from the same sample
+    bool readRegisterPair(uint8_t highReg, uint8_t lowReg, uint8_t &high, uint8_t &low)
+    {
+        uint8_t buf[2];
+        if (lowReg == highReg + 1) {
+            if (readRegister(highReg, buf, 2) == -1)return false;
+            high = buf[0];
+            low = buf[1];
+            return true;
+        }
+        if (highReg == lowReg + 1) {
+            if (readRegister(lowReg, buf, 2) == -1)return false;
+            low = buf[0];
+            high = buf[1];
+            return true;
+        }
+        int h = readRegister(highReg);
+        int l = readRegister(lowReg);
+        if (h == -1 || l == -1)return false;
+        high = h;
+        low = l;
+        return true;
+    }
+
+    bool readRegisterBurst(uint8_t reg, uint16_t *values, uint8_t count,
+                           uint8_t highMask, uint8_t highShift, uint8_t lowMask)
+    {
+        uint8_t buf[32];
+        while (count) {
+            uint8_t n = count < sizeof(buf) / 2 ? count : sizeof(buf) / 2;
+            if (readRegister(reg, buf, n * 2) == -1) {
+                return false;
+            }
+            for (uint8_t i = 0; i < n; ++i) {
+                values[i] = ((buf[i * 2] & highMask) << highShift) | (buf[i * 2 + 1] & lowMask);
+            }
+            reg += n * 2;
+            values += n;
+            count -= n;
+        }
+        return true;
+    }
+
     /*
      * CRTP Helper
      */
@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/cdefs.h>
 #include "sdkconfig.h"
 
@@ -24,10 +25,15 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_lcd_panel_st7735.h"
 
 #define st7735_CMD_RAMCTRL               0xb0
 #define st7735_DATA_LITTLE_ENDIAN_BIT    (1 << 3)
 
+// RGB565 to 12 bit RGB444, keeping the 4 most significant bits of each component
+#define st7735_RGB565_TO_444(c)          ((((c) >> 4) & 0xf00) | (((c) >> 3) & 0x0f0) | (((c) >> 1) & 0x00f))
+#define st7735_SWAP16(c)                 ((uint16_t)(((c) >> 8) | ((c) << 8)))
+
 static const char *TAG = "lcd_panel.st7735";
 
 static esp_err_t panel_st7735_del(esp_lcd_panel_t *panel);
@@ -54,8 +60,21 @@ typedef struct {
     uint8_t colmod_val;    // save current value of LCD_CMD_COLMOD register
     uint8_t ramctl_val_1;
     uint8_t ramctl_val_2;
+    // Last CASET/RASET parameters sent, RAMWR restarts at the window origin
+    // so an unchanged window doesn't need to be sent again
+    bool window_cache;
+    bool window_valid;
+    uint8_t caset[4];
+    uint8_t raset[4];
+    uint32_t window_sent;
+    uint32_t window_skipped;
 } st7735_panel_t;
 
+static inline void st7735_invalidate_window(st7735_panel_t *st7735)
+{
+    st7735->window_valid = false;
+}
+
 esp_err_t
 esp_lcd_new_panel_st7735(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
                          esp_lcd_panel_handle_t *ret_panel)
@@ -95,6 +114,10 @@ esp_lcd_new_panel_st7735(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel
         st7735->colmod_val = 0x55;
         fb_bits_per_pixel = 16;
         break;
+    case 12: // RGB444
+        st7735->colmod_val = 0x53;
+        fb_bits_per_pixel = 12;
+        break;
     case 18: // RGB666
         st7735->colmod_val = 0x66;
         // each color component (R/G/B) should occupy the 6 high bits of a byte, which means 3 full bytes are required for a pixel
@@ -116,6 +139,7 @@ esp_lcd_new_panel_st7735(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel
     st7735->fb_bits_per_pixel = fb_bits_per_pixel;
     st7735->reset_gpio_num = panel_dev_config->reset_gpio_num;
     st7735->reset_level = panel_dev_config->flags.reset_active_high;
+    st7735->window_cache = true;
     st7735->base.del = panel_st7735_del;
     st7735->base.reset = panel_st7735_reset;
     st7735->base.init = panel_st7735_init;
@@ -141,6 +165,95 @@ err:
     return ret;
 }
 
+size_t esp_lcd_st7735_pack_rgb444(const uint16_t *src, uint8_t *dst, size_t pixels, bool swapped)
+{
+    // Each pair reads 4 bytes and writes 3 at or before them, so packing in place is safe
+    uint8_t *out = dst;
+    size_t pairs = pixels / 2;
+    uint32_t c0, c1;
+
+    if (swapped) {
+        for (size_t i = 0; i < pairs; i++, src += 2) {
+            c0 = st7735_RGB565_TO_444(st7735_SWAP16(src[0]));
+            c1 = st7735_RGB565_TO_444(st7735_SWAP16(src[1]));
+            out[0] = c0 >> 4;
+            out[1] = (c0 << 4) | (c1 >> 8);
+            out[2] = c1;
+            out += 3;
+        }
+    } else {
+        for (size_t i = 0; i < pairs; i++, src += 2) {
+            c0 = st7735_RGB565_TO_444(src[0]);
+            c1 = st7735_RGB565_TO_444(src[1]);
+            out[0] = c0 >> 4;
+            out[1] = (c0 << 4) | (c1 >> 8);
+            out[2] = c1;
+            out += 3;
+        }
+    }
+
+    if (pixels & 1) {
+        c0 = st7735_RGB565_TO_444(swapped ? st7735_SWAP16(src[0]) : src[0]);
+        out[0] = c0 >> 4;
+        out[1] = c0 << 4;
+        out += 2;
+    }
+
+    return out - dst;
+}
+
+esp_err_t esp_lcd_st7735_set_window_cache(esp_lcd_panel_handle_t panel, bool enable)
+{
+    ESP_RETURN_ON_FALSE(panel && panel->draw_bitmap == panel_st7735_draw_bitmap, ESP_ERR_INVALID_ARG, TAG,
+                        "not a st7735 panel");
+    st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735->window_cache = enable;
+    st7735_invalidate_window(st7735);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7735_get_window_stats(esp_lcd_panel_handle_t panel, uint32_t *sent, uint32_t *skipped)
+{
+    ESP_RETURN_ON_FALSE(panel && panel->draw_bitmap == panel_st7735_draw_bitmap, ESP_ERR_INVALID_ARG, TAG,
+                        "not a st7735 panel");
+    st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    if (sent) {
+        *sent = st7735->window_sent;
+    }
+    if (skipped) {
+        *skipped = st7735->window_skipped;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_st7735_set_orientation(esp_lcd_panel_handle_t panel, bool swap_axes, bool mirror_x, bool mirror_y,
+                                        int x_gap, int y_gap)
+{
+    ESP_RETURN_ON_FALSE(panel && panel->draw_bitmap == panel_st7735_draw_bitmap, ESP_ERR_INVALID_ARG, TAG,
+                        "not a st7735 panel");
+    st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735_invalidate_window(st7735);
+
+    uint8_t madctl_val = st7735->madctl_val & ~(LCD_CMD_MV_BIT | LCD_CMD_MX_BIT | LCD_CMD_MY_BIT);
+    if (swap_axes) {
+        madctl_val |= LCD_CMD_MV_BIT;
+    }
+    if (mirror_x) {
+        madctl_val |= LCD_CMD_MX_BIT;
+    }
+    if (mirror_y) {
+        madctl_val |= LCD_CMD_MY_BIT;
+    }
+    // One MADCTL write, the panel never scans out an intermediate orientation
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(st7735->io, LCD_CMD_MADCTL, (uint8_t[]) {
+        madctl_val
+    }, 1), TAG, "io tx param failed");
+    st7735->madctl_val = madctl_val;
+    st7735->x_gap = x_gap;
+    st7735->y_gap = y_gap;
+    return ESP_OK;
+}
+
 static esp_err_t panel_st7735_del(esp_lcd_panel_t *panel)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
@@ -157,6 +270,7 @@ static esp_err_t panel_st7735_reset(esp_lcd_panel_t *panel)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7735->io;
+    st7735_invalidate_window(st7735);
 
     // perform hardware reset
     if (st7735->reset_gpio_num >= 0) {
@@ -177,6 +291,7 @@ static esp_err_t panel_st7735_init(esp_lcd_panel_t *panel)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
     esp_lcd_panel_io_handle_t io = st7735->io;
+    st7735_invalidate_window(st7735);
     // LCD goes into sleep mode and display will be turned off after power on reset, exit sleep mode first
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0), TAG,
                         "io tx param failed");
@@ -207,20 +322,39 @@ static esp_err_t panel_st7735_draw_bitmap(esp_lcd_panel_t *panel, int x_start, i
     y_end += st7735->y_gap;
 
     // define an area of frame memory where MCU can access
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, (uint8_t[]) {
+    const uint8_t caset[4] = {
         (x_start >> 8) & 0xFF,
         x_start & 0xFF,
         ((x_end - 1) >> 8) & 0xFF,
         (x_end - 1) & 0xFF,
-    }, 4), TAG, "io tx param failed");
-    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, (uint8_t[]) {
+    };
+    const uint8_t raset[4] = {
         (y_start >> 8) & 0xFF,
         y_start & 0xFF,
         ((y_end - 1) >> 8) & 0xFF,
         (y_end - 1) & 0xFF,
-    }, 4), TAG, "io tx param failed");
+    };
+    // Every parameter transaction first waits for the queued color transfers,
+    // so each one skipped also keeps the DMA queue from draining
+    bool cached = st7735->window_cache && st7735->window_valid;
+    st7735->window_valid = false;
+    if (!cached || memcmp(caset, st7735->caset, sizeof(caset)) != 0) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_CASET, caset, 4), TAG, "io tx param failed");
+        memcpy(st7735->caset, caset, sizeof(caset));
+        st7735->window_sent++;
+    } else {
+        st7735->window_skipped++;
+    }
+    if (!cached || memcmp(raset, st7735->raset, sizeof(raset)) != 0) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_RASET, raset, 4), TAG, "io tx param failed");
+        memcpy(st7735->raset, raset, sizeof(raset));
+        st7735->window_sent++;
+    } else {
+        st7735->window_skipped++;
+    }
+    st7735->window_valid = true;
     // transfer frame buffer
-    size_t len = (x_end - x_start) * (y_end - y_start) * st7735->fb_bits_per_pixel / 8;
+    size_t len = ((x_end - x_start) * (y_end - y_start) * st7735->fb_bits_per_pixel + 7) / 8;
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(io, LCD_CMD_RAMWR, color_data, len), TAG, "io tx color failed");
 
     return ESP_OK;
@@ -244,6 +378,7 @@ static esp_err_t panel_st7735_invert_color(esp_lcd_panel_t *panel, bool invert_c
 static esp_err_t panel_st7735_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735_invalidate_window(st7735);
     esp_lcd_panel_io_handle_t io = st7735->io;
     if (mirror_x) {
         st7735->madctl_val |= LCD_CMD_MX_BIT;
@@ -264,6 +399,7 @@ static esp_err_t panel_st7735_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool
 static esp_err_t panel_st7735_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735_invalidate_window(st7735);
     esp_lcd_panel_io_handle_t io = st7735->io;
     if (swap_axes) {
         st7735->madctl_val |= LCD_CMD_MV_BIT;
@@ -279,6 +415,7 @@ static esp_err_t panel_st7735_swap_xy(esp_lcd_panel_t *panel, bool swap_axes)
 static esp_err_t panel_st7735_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735_invalidate_window(st7735);
     st7735->x_gap = x_gap;
     st7735->y_gap = y_gap;
     return ESP_OK;
@@ -302,6 +439,7 @@ static esp_err_t panel_st7735_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
 static esp_err_t panel_st7735_sleep(esp_lcd_panel_t *panel, bool sleep)
 {
     st7735_panel_t *st7735 = __containerof(panel, st7735_panel_t, base);
+    st7735_invalidate_window(st7735);
     esp_lcd_panel_io_handle_t io = st7735->io;
     int command = 0;
     if (sleep) {
@@ -311,7 +449,9 @@ static esp_err_t panel_st7735_sleep(esp_lcd_panel_t *panel, bool sleep)
     }
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, command, NULL, 0), TAG,
                         "io tx param failed");
-    vTaskDelay(pdMS_TO_TICKS(100));
+    // Sleep out only needs 5 ms before the next command, so waking up is quick.
+    // Sleep in waits the 120 ms that must separate it from the next sleep out.
+    vTaskDelay(pdMS_TO_TICKS(sleep ? 120 : 5));
 
     return ESP_OK;
 }
@@ -6,6 +6,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "esp_lcd_panel_dev.h"
 
@@ -16,6 +18,10 @@ extern "C" {
 /**
  * @brief Create LCD panel for model st7735
  *
+ * @note bits_per_pixel can be 16 (RGB565), 18 (RGB666) or 12 (RGB444). In 12 bpp mode
+ *       `esp_lcd_panel_draw_bitmap()` expects the color data already packed with
+ *       `esp_lcd_st7735_pack_rgb444()`, two pixels in three bytes.
+ *
  * @param[in] io LCD panel IO handle
  * @param[in] panel_dev_config general panel device configuration
  * @param[out] ret_panel Returned LCD panel handle
@@ -26,6 +32,67 @@ extern "C" {
  */
 esp_err_t esp_lcd_new_panel_st7735(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Pack RGB565 pixels into the RGB444 stream used by the 12 bpp mode
+ *
+ * Every two pixels become three bytes: R0G0 B0R1 G1B1. An odd trailing pixel takes
+ * two bytes, the last nibble being padding. `dst` may be the same buffer as `src`,
+ * the packed data then occupies the first `(pixels * 3 + 1) / 2` bytes.
+ *
+ * @param[in] src RGB565 pixels
+ * @param[out] dst Packed RGB444 data
+ * @param[in] pixels Number of pixels in `src`
+ * @param[in] swapped The RGB565 values in `src` are byte swapped (LV_COLOR_16_SWAP)
+ * @return Number of bytes written to `dst`
+ */
+size_t esp_lcd_st7735_pack_rgb444(const uint16_t *src, uint8_t *dst, size_t pixels, bool swapped);
+
+/**
+ * @brief Skip the CASET/RASET commands when a draw uses the same window as the last one
+ *
+ * Enabled by default. Only the command whose parameters changed is sent, the cache is
+ * dropped on reset, init, sleep, gap, mirror and swap changes and when a command fails.
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_st7735()`
+ * @param[in] enable Use the window cache
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the panel is not a st7735 panel
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7735_set_window_cache(esp_lcd_panel_handle_t panel, bool enable);
+
+/**
+ * @brief Number of address commands sent and skipped since the panel was created
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_st7735()`
+ * @param[out] sent CASET/RASET commands sent, may be NULL
+ * @param[out] skipped CASET/RASET commands skipped by the window cache, may be NULL
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the panel is not a st7735 panel
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7735_get_window_stats(esp_lcd_panel_handle_t panel, uint32_t *sent, uint32_t *skipped);
+
+/**
+ * @brief Set swap, mirror and gap in one go, for rotating the panel at runtime
+ *
+ * Same result as `esp_lcd_panel_swap_xy()`, `esp_lcd_panel_mirror()` and `esp_lcd_panel_set_gap()`
+ * but with a single MADCTL write. Queued color transfers are sent before the command, draws that
+ * follow use the new orientation.
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_st7735()`
+ * @param[in] swap_axes Exchange rows and columns (MV)
+ * @param[in] mirror_x Mirror the column address (MX)
+ * @param[in] mirror_y Mirror the row address (MY)
+ * @param[in] x_gap Column offset of the visible area in the new orientation
+ * @param[in] y_gap Row offset of the visible area in the new orientation
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if the panel is not a st7735 panel
+ *          - ESP_OK                on success
+ */
+esp_err_t esp_lcd_st7735_set_orientation(esp_lcd_panel_handle_t panel, bool swap_axes, bool mirror_x, bool mirror_y,
+                                        int x_gap, int y_gap);
+
 #ifdef __cplusplus
 }
 #endif
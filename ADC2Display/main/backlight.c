@@ -0,0 +1,239 @@
+/// \file		backlight.c
+///
+/// \brief	LEDC backlight with fades, dimming and ambient input
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include "driver/ledc.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "product_pins.h"
+#include "backlight.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define BACKLIGHT_MODE              LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_TIMER             LEDC_TIMER_0
+#define BACKLIGHT_CHANNEL           LEDC_CHANNEL_0
+#define BACKLIGHT_RESOLUTION        LEDC_TIMER_13_BIT
+#define BACKLIGHT_MAX_DUTY          ((1 << 13) - 1)
+#define BACKLIGHT_FREQ_HZ           5000
+#define BACKLIGHT_AMBIENT_PERIOD_US (1000 * 1000)
+// Ambient changes smaller than this (percent) don't restart a fade
+#define BACKLIGHT_AMBIENT_HYST      5
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Fade to a perceived brightness and account the duty
+ */
+static void _fadeTo(uint8_t percent, uint32_t fadeMs);
+
+/**
+ * @brief Active level scaled by the last ambient reading
+ */
+static uint8_t _activeLevel(void);
+
+static void _accountDuty(void);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "backlight";
+
+static backlightConfig_t blConfig;
+static backlightState_t blState = BACKLIGHT_ACTIVE;
+static uint8_t blLevel = 0;             // Level currently faded to
+
+static backlightAmbientCb_t ambientCb = NULL;
+static void *ambientCtx = NULL;
+static uint8_t ambient = 100;
+static int64_t ambientLastUs = 0;
+
+// Duty integral, for the average duty
+static uint32_t duty = 0;
+static uint64_t dutyIntegral = 0;
+static int64_t dutyLastUs = 0;
+static int64_t dutyStartUs = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+esp_err_t backlightInit(const backlightConfig_t *config)
+{
+    blConfig = *config;
+
+    const ledc_timer_config_t timerConfig = {
+        .speed_mode = BACKLIGHT_MODE,
+        .duty_resolution = BACKLIGHT_RESOLUTION,
+        .timer_num = BACKLIGHT_TIMER,
+        .freq_hz = BACKLIGHT_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_RETURN_ON_ERROR(ledc_timer_config(&timerConfig), TAG, "timer config failed");
+
+    const ledc_channel_config_t channelConfig = {
+        .gpio_num = BOARD_TFT_BL,
+        .speed_mode = BACKLIGHT_MODE,
+        .channel = BACKLIGHT_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = BACKLIGHT_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ESP_RETURN_ON_ERROR(ledc_channel_config(&channelConfig), TAG, "channel config failed");
+    ESP_RETURN_ON_ERROR(ledc_fade_func_install(0), TAG, "fade install failed");
+
+    dutyStartUs = dutyLastUs = esp_timer_get_time();
+    blState = BACKLIGHT_ACTIVE;
+    _fadeTo(_activeLevel(), blConfig.fadeMs);
+
+    return ESP_OK;
+}
+
+void backlightSetLevel(uint8_t percent, uint32_t fadeMs)
+{
+    blConfig.activeLevel = percent > 100 ? 100 : percent;
+    if (blState == BACKLIGHT_ACTIVE) {
+        _fadeTo(_activeLevel(), fadeMs);
+    }
+}
+
+uint8_t backlightGetLevel(void)
+{
+    return blLevel;
+}
+
+backlightState_t backlightGetState(void)
+{
+    return blState;
+}
+
+void backlightSetAmbientCb(backlightAmbientCb_t cb, void *ctx)
+{
+    ambientCtx = ctx;
+    ambientCb = cb;
+    ambientLastUs = 0;
+}
+
+uint32_t backlightSetState(backlightState_t state)
+{
+    if (state == blState) {
+        return 0;
+    }
+
+    // Coming back from off is a wake up, anything else is a slow fade
+    const uint32_t fadeMs = blState == BACKLIGHT_OFF ? blConfig.wakeFadeMs : blConfig.fadeMs;
+    switch (state) {
+    case BACKLIGHT_ACTIVE:
+        _fadeTo(_activeLevel(), fadeMs);
+        break;
+    case BACKLIGHT_DIMMED:
+        _fadeTo(blConfig.dimLevel < _activeLevel() ? blConfig.dimLevel : _activeLevel(), fadeMs);
+        break;
+    case BACKLIGHT_OFF:
+        _fadeTo(0, fadeMs);
+        break;
+    }
+
+    blState = state;
+    ESP_LOGI(TAG, "state=%d level=%u avg_duty_permille=%lu",
+             state, blLevel, (unsigned long)backlightGetAverageDuty());
+    return fadeMs;
+}
+
+void backlightProcess(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    if (ambientCb && now - ambientLastUs >= BACKLIGHT_AMBIENT_PERIOD_US) {
+        ambientLastUs = now;
+        uint8_t reading = ambientCb(ambientCtx);
+        ambient = reading > 100 ? 100 : reading;
+
+        uint8_t level = _activeLevel();
+        if (blState == BACKLIGHT_ACTIVE && abs((int)level - (int)blLevel) >= BACKLIGHT_AMBIENT_HYST) {
+            _fadeTo(level, blConfig.fadeMs);
+        }
+    }
+}
+
+uint32_t backlightGetAverageDuty(void)
+{
+    _accountDuty();
+    int64_t elapsed = dutyLastUs - dutyStartUs;
+    if (elapsed <= 0) {
+        return duty * 1000 / BACKLIGHT_MAX_DUTY;
+    }
+    return (uint32_t)(dutyIntegral / (uint64_t)elapsed * 1000 / BACKLIGHT_MAX_DUTY);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _fadeTo(uint8_t percent, uint32_t fadeMs)
+{
+    // Square law, the eye is far more sensitive at low duty
+    uint32_t target = (uint32_t)BACKLIGHT_MAX_DUTY * percent * percent / 10000;
+
+    _accountDuty();
+    duty = target;
+    blLevel = percent;
+
+    ledc_fade_stop(BACKLIGHT_MODE, BACKLIGHT_CHANNEL);
+    if (fadeMs) {
+        ledc_set_fade_with_time(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, target, fadeMs);
+        ledc_fade_start(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, LEDC_FADE_NO_WAIT);
+    } else {
+        ledc_set_duty(BACKLIGHT_MODE, BACKLIGHT_CHANNEL, target);
+        ledc_update_duty(BACKLIGHT_MODE, BACKLIGHT_CHANNEL);
+    }
+}
+
+uint8_t _activeLevel(void)
+{
+    return (uint16_t)blConfig.activeLevel * ambient / 100;
+}
+
+void _accountDuty(void)
+{
+    // Fades are short, the duty is counted at its target right away
+    int64_t now = esp_timer_get_time();
+    dutyIntegral += (uint64_t)duty * (uint64_t)(now - dutyLastUs);
+    dutyLastUs = now;
+}
@@ -0,0 +1,111 @@
+/// \file		backlight.h
+///
+/// \brief	LEDC backlight with fades, dimming and ambient input
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+    BACKLIGHT_ACTIVE,
+    BACKLIGHT_DIMMED,
+    BACKLIGHT_OFF,
+} backlightState_t;
+
+/**
+ * @brief Ambient light in percent of the brightest expected environment
+ */
+typedef uint8_t (*backlightAmbientCb_t)(void *ctx);
+
+/**
+ * Levels are perceived brightness in percent. Waking up uses the shorter
+ * wake fade, so the screen is readable right away.
+ */
+typedef struct {
+    uint8_t activeLevel;
+    uint8_t dimLevel;
+    uint32_t fadeMs;
+    uint32_t wakeFadeMs;
+} backlightConfig_t;
+
+#define BACKLIGHT_CONFIG_DEFAULT()      \
+    {                                   \
+        .activeLevel = 100,             \
+        .dimLevel = 20,                 \
+        .fadeMs = 400,                  \
+        .wakeFadeMs = 100,              \
+    }
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Configure the LEDC channel and fade in to the active level
+ */
+esp_err_t backlightInit(const backlightConfig_t *config);
+
+/**
+ * @brief Change the active level, with a fade of \p fadeMs
+ */
+void backlightSetLevel(uint8_t percent, uint32_t fadeMs);
+
+uint8_t backlightGetLevel(void);
+backlightState_t backlightGetState(void);
+
+/**
+ * @brief Scale the active level by an ambient light reading
+ *
+ * \p cb is polled about once per second from backlightProcess().
+ */
+void backlightSetAmbientCb(backlightAmbientCb_t cb, void *ctx);
+
+/**
+ * @brief Fade to the level of \p state
+ *
+ * Driven by displayPower, which owns the inactivity timers.
+ *
+ * @return Duration of the fade in milliseconds
+ */
+uint32_t backlightSetState(backlightState_t state);
+
+/**
+ * @brief Poll the ambient callback, call periodically
+ */
+void backlightProcess(void);
+
+/**
+ * @brief Average duty since boot, in per mille
+ *
+ * Proportional to the backlight current, for battery life estimates.
+ */
+uint32_t backlightGetAverageDuty(void);
+
+#endif // BACKLIGHT_H
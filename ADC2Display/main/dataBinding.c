@@ -0,0 +1,227 @@
+/// \file		dataBinding.c
+///
+/// \brief	Typed value slots bound to widgets, with change detection
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "dataBinding.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define BINDING_TEXT_LEN            32
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    dataBindingValue_t value;
+    uint32_t seq;                   // Incremented on every change
+} _slot_t;
+
+typedef struct {
+    uint8_t slot;
+    uint32_t seenSeq;               // Sequence number last applied
+    uint32_t lastApplyMs;
+    uint32_t minPeriodMs;
+    dataBindingApply_t apply;
+    void *ctx;
+    lv_obj_t *label;                // Label bindings use these two
+    dataBindingFormat_t format;
+} _binding_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+static void _publish(uint8_t slot, const dataBindingValue_t *value);
+static _binding_t *_addBinding(uint8_t slot, uint16_t maxHz);
+
+/**
+ * @brief Set the text of a label bound to a slot
+ */
+static void _setLabelText(lv_obj_t *label, const char *text);
+
+static void _defaultFormat(const dataBindingValue_t *value, char *buf, size_t len);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "dataBinding";
+
+// Producers may run on either core
+static portMUX_TYPE slotLock = portMUX_INITIALIZER_UNLOCKED;
+
+static _slot_t slots[DATA_BINDING_MAX_SLOTS];
+static _binding_t bindings[DATA_BINDING_MAX_BINDINGS];
+static int bindingCount = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void dataBindingPublishInt(uint8_t slot, int32_t value)
+{
+    const dataBindingValue_t v = { .type = DATA_SLOT_INT, .i = value };
+    _publish(slot, &v);
+}
+
+void dataBindingPublishFloat(uint8_t slot, float value)
+{
+    const dataBindingValue_t v = { .type = DATA_SLOT_FLOAT, .f = value };
+    _publish(slot, &v);
+}
+
+uint32_t dataBindingRead(uint8_t slot, dataBindingValue_t *value)
+{
+    if (slot >= DATA_BINDING_MAX_SLOTS) {
+        value->type = DATA_SLOT_NONE;
+        return 0;
+    }
+
+    portENTER_CRITICAL(&slotLock);
+    *value = slots[slot].value;
+    uint32_t seq = slots[slot].seq;
+    portEXIT_CRITICAL(&slotLock);
+
+    return seq;
+}
+
+bool dataBindingBind(uint8_t slot, dataBindingApply_t apply, void *ctx, uint16_t maxHz)
+{
+    _binding_t *binding = _addBinding(slot, maxHz);
+    if (!binding) {
+        return false;
+    }
+    binding->apply = apply;
+    binding->ctx = ctx;
+    return true;
+}
+
+bool dataBindingBindLabel(uint8_t slot, lv_obj_t *label, dataBindingFormat_t format, uint16_t maxHz)
+{
+    _binding_t *binding = _addBinding(slot, maxHz);
+    if (!binding) {
+        return false;
+    }
+    binding->label = label;
+    binding->format = format ? format : _defaultFormat;
+    return true;
+}
+
+void dataBindingProcess(void)
+{
+    uint32_t now = lv_tick_get();
+
+    // A sequence number compare per binding when nothing changed
+    for (int i = 0; i < bindingCount; i++) {
+        _binding_t *binding = &bindings[i];
+        if (slots[binding->slot].seq == binding->seenSeq) {
+            continue;
+        }
+        if (binding->minPeriodMs && lv_tick_elaps(binding->lastApplyMs) < binding->minPeriodMs) {
+            // Still pending, applied once the period has elapsed
+            continue;
+        }
+
+        dataBindingValue_t value;
+        binding->seenSeq = dataBindingRead(binding->slot, &value);
+        binding->lastApplyMs = now;
+
+        if (binding->label) {
+            char text[BINDING_TEXT_LEN];
+            binding->format(&value, text, sizeof(text));
+            _setLabelText(binding->label, text);
+        } else {
+            binding->apply(binding->ctx, &value);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _publish(uint8_t slot, const dataBindingValue_t *value)
+{
+    if (slot >= DATA_BINDING_MAX_SLOTS) {
+        return;
+    }
+
+    portENTER_CRITICAL(&slotLock);
+    _slot_t *s = &slots[slot];
+    // Raw compare, also for floats: any bit change is a change
+    if (s->value.type != value->type || s->value.i != value->i) {
+        s->value = *value;
+        s->seq++;
+    }
+    portEXIT_CRITICAL(&slotLock);
+}
+
+_binding_t *_addBinding(uint8_t slot, uint16_t maxHz)
+{
+    if (slot >= DATA_BINDING_MAX_SLOTS || bindingCount >= DATA_BINDING_MAX_BINDINGS) {
+        ESP_LOGE(TAG, "Unable to bind slot %u", slot);
+        return NULL;
+    }
+
+    _binding_t *binding = &bindings[bindingCount++];
+    memset(binding, 0, sizeof(*binding));
+    binding->slot = slot;
+    binding->minPeriodMs = maxHz ? 1000 / maxHz : 0;
+    // Apply on the first frame even if nothing was published yet
+    binding->seenSeq = slots[slot].seq - 1;
+    return binding;
+}
+
+void _setLabelText(lv_obj_t *label, const char *text)
+{
+    // Setting the same text would still invalidate the label
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void _defaultFormat(const dataBindingValue_t *value, char *buf, size_t len)
+{
+    switch (value->type) {
+    case DATA_SLOT_INT:
+        snprintf(buf, len, "%ld", (long)value->i);
+        break;
+    case DATA_SLOT_FLOAT:
+        snprintf(buf, len, "%.2f", value->f);
+        break;
+    default:
+        snprintf(buf, len, "-");
+        break;
+    }
+}
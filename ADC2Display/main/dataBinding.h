@@ -0,0 +1,104 @@
+/// \file		dataBinding.h
+///
+/// \brief	Typed value slots bound to widgets, with change detection
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DATA_BINDING_H
+#define DATA_BINDING_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#define DATA_BINDING_MAX_SLOTS      32
+#define DATA_BINDING_MAX_BINDINGS   32
+
+typedef enum {
+    DATA_SLOT_NONE,
+    DATA_SLOT_INT,
+    DATA_SLOT_FLOAT,
+} dataSlotType_t;
+
+typedef struct {
+    dataSlotType_t type;
+    union {
+        int32_t i;
+        float f;
+    };
+} dataBindingValue_t;
+
+/**
+ * @brief Turn a value into the text of a label
+ */
+typedef void (*dataBindingFormat_t)(const dataBindingValue_t *value, char *buf, size_t len);
+
+/**
+ * @brief Hand a value to a widget, runs in the task owning LVGL
+ */
+typedef void (*dataBindingApply_t)(void *ctx, const dataBindingValue_t *value);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Publish a value into a slot, from any task
+ *
+ * Never blocks. The slot sequence number only moves when the value differs
+ * from the current one, so republishing the same value costs no redraw.
+ */
+void dataBindingPublishInt(uint8_t slot, int32_t value);
+void dataBindingPublishFloat(uint8_t slot, float value);
+
+/**
+ * @brief Read the current value and its sequence number
+ */
+uint32_t dataBindingRead(uint8_t slot, dataBindingValue_t *value);
+
+/**
+ * @brief Bind a slot to a callback
+ *
+ * @param maxHz Highest rate the callback is called at, 0 for every frame
+ */
+bool dataBindingBind(uint8_t slot, dataBindingApply_t apply, void *ctx, uint16_t maxHz);
+
+/**
+ * @brief Bind a slot to a label
+ *
+ * The label text is only set when the formatted text changed.
+ *
+ * @param format NULL for "%ld" / "%.2f"
+ */
+bool dataBindingBindLabel(uint8_t slot, lv_obj_t *label, dataBindingFormat_t format, uint16_t maxHz);
+
+/**
+ * @brief Apply the slots that changed since the last call
+ *
+ * Call once per frame from the task owning LVGL, before lv_timer_handler().
+ */
+void dataBindingProcess(void);
+
+#endif // DATA_BINDING_H
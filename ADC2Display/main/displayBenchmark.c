@@ -0,0 +1,521 @@
+/// \file		displayBenchmark.c
+///
+/// \brief	Display throughput benchmark and SPI/buffer auto-calibration
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "lvgl.h"
+#include "tft_driver.h"
+#include "product_pins.h"
+#include "numericReadout.h"
+#include "displayMem.h"
+#include "displayBenchmark.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define BENCH_FULL_FRAMES           20
+#define BENCH_PARTIAL_UPDATES       200
+#define BENCH_PARTIAL_WIDTH         64
+#define BENCH_PARTIAL_HEIGHT        32
+#define BENCH_TRANS_TIMEOUT_MS      500
+// A configuration is stable when two runs differ by less than this (percent)
+#define BENCH_STABLE_SPREAD_PCT     10
+// Typical LVGL frames here are a handful of small areas, so partial updates
+// weigh more than a full redraw when ranking configurations
+#define BENCH_PARTIAL_WEIGHT        4
+#define BENCH_READOUT_UPDATES       200
+#define BENCH_READOUT_CELLS         5
+#define BENCH_TILE_UPDATES          1000
+#define BENCH_TILE_SIZE             16
+// Highest candidate clock. The ST7735 and ST7789 write cycle is specified
+// well below this, 40 MHz is what these panels are known to take in practice
+// and nothing above it is ever tried or accepted from NVS.
+#define BENCH_PCLK_MAX_HZ           (40 * 1000 * 1000)
+
+#define BENCH_NVS_NAMESPACE         "display"
+#define BENCH_NVS_KEY               "calib"
+#define BENCH_NVS_VERSION           2
+
+#define BENCH_COUNT(x)              (sizeof(x) / sizeof((x)[0]))
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+// Two buffers are ping-ponged like the LVGL draw buffers. Each one remembers
+// the transfer it was queued with.
+typedef struct {
+    uint16_t *buf[2];
+    uint32_t seq[2];
+    bool inFlight[2];
+    size_t pixels;
+    uint32_t errors;
+} _benchCtx_t;
+
+typedef struct {
+    uint32_t version;
+    display_config_t config;
+} _benchStored_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Fill a buffer with a deterministic pseudo random pattern
+ */
+static void _fillPattern(uint16_t *buf, size_t len, uint32_t seed);
+
+/**
+ * @brief Wait until a buffer is no longer owned by the DMA
+ *
+ * The panel can't be read back, so only completion is checked here: a
+ * transfer that times out counts as an error. What reached the panel is not
+ * verified, a clock that corrupts pixels is only kept out by the candidate
+ * list staying within BENCH_PCLK_MAX_HZ.
+ */
+static void _reclaim(_benchCtx_t *ctx, int idx);
+
+static void _push(_benchCtx_t *ctx, int idx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t seed);
+
+static uint32_t _runFull(_benchCtx_t *ctx, uint16_t lines);
+static uint32_t _runPartial(_benchCtx_t *ctx);
+
+/**
+ * @brief Push small tiles, all at the origin or walking along the first row
+ *
+ * @return Updates per second
+ */
+static uint32_t _runTiles(_benchCtx_t *ctx, bool walk);
+static uint32_t _score(const displayBenchmarkResult_t *result);
+static bool _storeConfig(const display_config_t *config);
+
+/**
+ * @brief Wait for every queued transfer, for timing a whole update
+ */
+static void _drain(void);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayBench";
+
+// Pixel clocks reachable from the 80 MHz APB clock, up to BENCH_PCLK_MAX_HZ
+static const uint32_t pclkCandidates[] = {
+    20 * 1000 * 1000,
+    26666666,
+    BENCH_PCLK_MAX_HZ,
+};
+
+static const uint16_t linesCandidates[] = { 10, 20, 40, 80 };
+
+static const uint8_t depthCandidates[] = { 1, 2, 4, 10 };
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+bool displayBenchmarkMeasure(const display_config_t *config, displayBenchmarkResult_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->config = *config;
+
+    if (display_init_with_config(config) != ESP_OK) {
+        ESP_LOGW(TAG, "Configuration rejected by the driver");
+        return false;
+    }
+
+    _benchCtx_t ctx = { 0 };
+    ctx.pixels = AMOLED_HEIGHT * config->draw_buf_lines;
+    ctx.buf[0] = (uint16_t *)displayMemDmaAlloc(ctx.pixels * sizeof(uint16_t));
+    ctx.buf[1] = (uint16_t *)displayMemDmaAlloc(ctx.pixels * sizeof(uint16_t));
+
+    if (ctx.buf[0] && ctx.buf[1]) {
+        uint32_t full1 = _runFull(&ctx, config->draw_buf_lines);
+        uint32_t full2 = _runFull(&ctx, config->draw_buf_lines);
+        uint32_t partial = _runPartial(&ctx);
+
+        uint32_t fullMin = full1 < full2 ? full1 : full2;
+        uint32_t fullMax = full1 < full2 ? full2 : full1;
+
+        result->fullFrameUs = (full1 + full2) / 2;
+        result->partialUs = partial;
+        result->fullFps = result->fullFrameUs ? 1000000 / result->fullFrameUs : 0;
+        result->partialKpps = partial ? (BENCH_PARTIAL_WIDTH * BENCH_PARTIAL_HEIGHT * 1000) / partial : 0;
+        result->stable = (ctx.errors == 0) &&
+                         (fullMax - fullMin) * 100 <= fullMin * BENCH_STABLE_SPREAD_PCT;
+    } else {
+        ESP_LOGW(TAG, "No DMA memory for %u line buffers", config->draw_buf_lines);
+    }
+
+    displayMemFree(ctx.buf[0]);
+    displayMemFree(ctx.buf[1]);
+    display_deinit();
+
+    ESP_LOGI(TAG, "pclk=%lu lines=%u depth=%u bpp=%u full_us=%lu fps=%lu partial_us=%lu kpps=%lu errors=%lu stable=%d",
+             (unsigned long)config->pclk_hz, config->draw_buf_lines, config->trans_queue_depth, config->bits_per_pixel,
+             (unsigned long)result->fullFrameUs, (unsigned long)result->fullFps,
+             (unsigned long)result->partialUs, (unsigned long)result->partialKpps,
+             (unsigned long)ctx.errors, result->stable);
+
+    return result->stable;
+}
+
+bool displayBenchmarkCalibrate(display_config_t *best)
+{
+    ESP_LOGI(TAG, "------ Display calibration ------");
+
+    // Coordinate search: clock first, then buffer size, then queue depth,
+    // each stage keeping the winner of the previous one
+    displayBenchmarkResult_t bestResult = { 0 };
+    displayBenchmarkResult_t result;
+    display_config_t candidate = DISPLAY_CONFIG_DEFAULT();
+    bool found = false;
+
+    for (size_t stage = 0; stage < 3; stage++) {
+        size_t count = stage == 0 ? BENCH_COUNT(pclkCandidates) :
+                       stage == 1 ? BENCH_COUNT(linesCandidates) :
+                       BENCH_COUNT(depthCandidates);
+
+        for (size_t i = 0; i < count; i++) {
+            candidate = found ? bestResult.config : candidate;
+            if (stage == 0) {
+                candidate.pclk_hz = pclkCandidates[i];
+            } else if (stage == 1) {
+                candidate.draw_buf_lines = linesCandidates[i];
+            } else {
+                candidate.trans_queue_depth = depthCandidates[i];
+            }
+
+            if (!displayBenchmarkMeasure(&candidate, &result)) {
+                continue;
+            }
+            if (!found || _score(&result) < _score(&bestResult)) {
+                bestResult = result;
+                found = true;
+            }
+        }
+    }
+
+    if (!found) {
+        ESP_LOGE(TAG, "No stable configuration found");
+        return false;
+    }
+
+    *best = bestResult.config;
+    ESP_LOGI(TAG, "Best: pclk=%lu lines=%u depth=%u fps=%lu kpps=%lu",
+             (unsigned long)best->pclk_hz, best->draw_buf_lines, best->trans_queue_depth,
+             (unsigned long)bestResult.fullFps, (unsigned long)bestResult.partialKpps);
+
+    // The pixel format is a product choice (DISPLAY_BITS_PER_PIXEL), it is
+    // only reported here, never picked by the search
+    displayBenchmarkComparePixelFormats(best);
+
+    return _storeConfig(best);
+}
+
+bool displayBenchmarkComparePixelFormats(const display_config_t *config)
+{
+    displayBenchmarkResult_t rgb565, rgb444;
+    display_config_t candidate = *config;
+
+    candidate.bits_per_pixel = 16;
+    bool ok565 = displayBenchmarkMeasure(&candidate, &rgb565);
+    candidate.bits_per_pixel = 12;
+    bool ok444 = displayBenchmarkMeasure(&candidate, &rgb444);
+
+    if (!ok565 || !ok444) {
+        ESP_LOGW(TAG, "Pixel format comparison incomplete: 16bpp=%d 12bpp=%d", ok565, ok444);
+        return false;
+    }
+
+    // Packing costs CPU time, so the gain is below the 25% saved on the wire
+    ESP_LOGI(TAG, "16bpp full_us=%lu partial_us=%lu | 12bpp full_us=%lu partial_us=%lu | gain full=%ld%% partial=%ld%%",
+             (unsigned long)rgb565.fullFrameUs, (unsigned long)rgb565.partialUs,
+             (unsigned long)rgb444.fullFrameUs, (unsigned long)rgb444.partialUs,
+             100 - (long)(rgb444.fullFrameUs * 100 / rgb565.fullFrameUs),
+             100 - (long)(rgb444.partialUs * 100 / rgb565.partialUs));
+    return true;
+}
+
+bool displayBenchmarkWindowCache(const display_config_t *config)
+{
+    if (display_init_with_config(config) != ESP_OK) {
+        ESP_LOGW(TAG, "Configuration rejected by the driver");
+        return false;
+    }
+
+    _benchCtx_t ctx = { 0 };
+    ctx.pixels = BENCH_TILE_SIZE * BENCH_TILE_SIZE;
+    ctx.buf[0] = (uint16_t *)displayMemDmaAlloc(ctx.pixels * sizeof(uint16_t));
+    ctx.buf[1] = (uint16_t *)displayMemDmaAlloc(ctx.pixels * sizeof(uint16_t));
+
+    uint32_t rate[2][2] = { 0 };        // [cache][walk]
+    uint32_t sent = 0, skipped = 0;
+    if (ctx.buf[0] && ctx.buf[1]) {
+        for (int cache = 0; cache < 2; cache++) {
+            display_set_window_cache(cache);
+            for (int walk = 0; walk < 2; walk++) {
+                rate[cache][walk] = _runTiles(&ctx, walk);
+            }
+        }
+        display_get_window_stats(&sent, &skipped);
+    } else {
+        ESP_LOGW(TAG, "No DMA memory for the tiles");
+    }
+
+    displayMemFree(ctx.buf[0]);
+    displayMemFree(ctx.buf[1]);
+    display_deinit();
+
+    ESP_LOGI(TAG, "tile=%ux%u same_window ups=%lu->%lu | walking ups=%lu->%lu | addr_sent=%lu addr_skipped=%lu errors=%lu",
+             BENCH_TILE_SIZE, BENCH_TILE_SIZE,
+             (unsigned long)rate[0][0], (unsigned long)rate[1][0],
+             (unsigned long)rate[0][1], (unsigned long)rate[1][1],
+             (unsigned long)sent, (unsigned long)skipped, (unsigned long)ctx.errors);
+    return ctx.errors == 0 && rate[1][0] != 0;
+}
+
+void displayBenchmarkReadout(lv_obj_t *parent)
+{
+    // Label: text layout and redraw of the label area through LVGL
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_align(label, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_refr_now(NULL);
+    _drain();
+
+    uint32_t trans = display_get_trans_queued();
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_READOUT_UPDATES; i++) {
+        lv_label_set_text_fmt(label, "%lu", (unsigned long)((i * 37) % 4096));
+        lv_refr_now(NULL);
+    }
+    _drain();
+    uint32_t labelUs = (uint32_t)((esp_timer_get_time() - start) / BENCH_READOUT_UPDATES);
+    uint32_t labelTrans = display_get_trans_queued() - trans;
+    lv_obj_del(label);
+
+    // Readout: same values, only the changed cells are blitted
+    numericReadout_t *readout = numericReadoutCreate(parent, LV_FONT_DEFAULT, BENCH_READOUT_CELLS, 0,
+                                                     lv_color_black(), lv_color_white());
+    if (!readout) {
+        ESP_LOGW(TAG, "Unable to create the readout");
+        return;
+    }
+    lv_obj_align(numericReadoutGetObj(readout), LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_refr_now(NULL);
+    numericReadoutRefresh();
+    _drain();
+
+    trans = display_get_trans_queued();
+    start = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_READOUT_UPDATES; i++) {
+        numericReadoutSetValue(readout, (i * 37) % 4096);
+        numericReadoutRefresh();
+    }
+    _drain();
+    uint32_t readoutUs = (uint32_t)((esp_timer_get_time() - start) / BENCH_READOUT_UPDATES);
+    uint32_t readoutTrans = display_get_trans_queued() - trans;
+
+    numericReadoutDelete(readout);
+    lv_refr_now(NULL);
+
+    ESP_LOGI(TAG, "label_us=%lu label_transfers=%lu readout_us=%lu readout_transfers=%lu updates=%u",
+             (unsigned long)labelUs, (unsigned long)labelTrans,
+             (unsigned long)readoutUs, (unsigned long)readoutTrans, BENCH_READOUT_UPDATES);
+}
+
+bool displayBenchmarkLoadConfig(display_config_t *config)
+{
+    nvs_handle_t handle;
+    if (nvs_open(BENCH_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    _benchStored_t stored;
+    size_t size = sizeof(stored);
+    esp_err_t err = nvs_get_blob(handle, BENCH_NVS_KEY, &stored, &size);
+    nvs_close(handle);
+
+    if (err != ESP_OK || size != sizeof(stored) || stored.version != BENCH_NVS_VERSION) {
+        return false;
+    }
+    if (stored.config.pclk_hz > BENCH_PCLK_MAX_HZ) {
+        ESP_LOGW(TAG, "Ignoring stored pclk=%lu above the panel limit", (unsigned long)stored.config.pclk_hz);
+        return false;
+    }
+
+    *config = stored.config;
+    ESP_LOGI(TAG, "Using calibrated display: pclk=%lu lines=%u depth=%u bpp=%u",
+             (unsigned long)config->pclk_hz, config->draw_buf_lines, config->trans_queue_depth, config->bits_per_pixel);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _fillPattern(uint16_t *buf, size_t len, uint32_t seed)
+{
+    // xorshift32, never seeded with zero
+    uint32_t state = seed * 2654435761u + 1;
+    for (size_t i = 0; i < len; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        buf[i] = (uint16_t)state;
+    }
+}
+
+void _reclaim(_benchCtx_t *ctx, int idx)
+{
+    if (!ctx->inFlight[idx]) {
+        return;
+    }
+    ctx->inFlight[idx] = false;
+
+    if (!display_wait_trans_done(ctx->seq[idx], BENCH_TRANS_TIMEOUT_MS)) {
+        ESP_LOGW(TAG, "Transfer %lu timed out", (unsigned long)ctx->seq[idx]);
+        ctx->errors++;
+    }
+}
+
+void _push(_benchCtx_t *ctx, int idx, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t seed)
+{
+    _reclaim(ctx, idx);
+
+    _fillPattern(ctx->buf[idx], (size_t)w * h, seed);
+
+    if (display_push_colors(x, y, x + w, y + h, ctx->buf[idx]) != ESP_OK) {
+        ctx->errors++;
+        return;
+    }
+    ctx->seq[idx] = display_get_trans_queued();
+    ctx->inFlight[idx] = true;
+}
+
+uint32_t _runFull(_benchCtx_t *ctx, uint16_t lines)
+{
+    int idx = 0;
+    int64_t start = esp_timer_get_time();
+
+    for (uint32_t frame = 0; frame < BENCH_FULL_FRAMES; frame++) {
+        for (uint16_t y = 0; y < AMOLED_WIDTH; y += lines) {
+            uint16_t h = (AMOLED_WIDTH - y) < lines ? (AMOLED_WIDTH - y) : lines;
+            _push(ctx, idx, 0, y, AMOLED_HEIGHT, h, (frame << 16) | y);
+            idx ^= 1;
+        }
+    }
+    _reclaim(ctx, 0);
+    _reclaim(ctx, 1);
+
+    return (uint32_t)((esp_timer_get_time() - start) / BENCH_FULL_FRAMES);
+}
+
+uint32_t _runPartial(_benchCtx_t *ctx)
+{
+    int idx = 0;
+    size_t pixels = BENCH_PARTIAL_WIDTH * BENCH_PARTIAL_HEIGHT;
+    uint16_t h = pixels <= ctx->pixels ? BENCH_PARTIAL_HEIGHT : ctx->pixels / BENCH_PARTIAL_WIDTH;
+    int64_t start = esp_timer_get_time();
+
+    for (uint32_t i = 0; i < BENCH_PARTIAL_UPDATES; i++) {
+        // Walk the area over the screen so the window changes every time
+        uint16_t x = (i * 37) % (AMOLED_HEIGHT - BENCH_PARTIAL_WIDTH);
+        uint16_t y = (i * 23) % (AMOLED_WIDTH - h);
+        _push(ctx, idx, x, y, BENCH_PARTIAL_WIDTH, h, 0x80000000u | i);
+        idx ^= 1;
+    }
+    _reclaim(ctx, 0);
+    _reclaim(ctx, 1);
+
+    return (uint32_t)((esp_timer_get_time() - start) / BENCH_PARTIAL_UPDATES);
+}
+
+uint32_t _runTiles(_benchCtx_t *ctx, bool walk)
+{
+    int idx = 0;
+    const uint16_t columns = AMOLED_HEIGHT / BENCH_TILE_SIZE;
+    int64_t start = esp_timer_get_time();
+
+    for (uint32_t i = 0; i < BENCH_TILE_UPDATES; i++) {
+        // Walking keeps the rows, so only the columns change
+        uint16_t x = walk ? (i % columns) * BENCH_TILE_SIZE : 0;
+        _push(ctx, idx, x, 0, BENCH_TILE_SIZE, BENCH_TILE_SIZE, i);
+        idx ^= 1;
+    }
+    _reclaim(ctx, 0);
+    _reclaim(ctx, 1);
+
+    int64_t elapsed = esp_timer_get_time() - start;
+    return elapsed > 0 ? (uint32_t)(BENCH_TILE_UPDATES * 1000000LL / elapsed) : 0;
+}
+
+void _drain(void)
+{
+    if (!display_wait_trans_done(display_get_trans_queued(), BENCH_TRANS_TIMEOUT_MS)) {
+        ESP_LOGW(TAG, "Transfers did not complete");
+    }
+}
+
+uint32_t _score(const displayBenchmarkResult_t *result)
+{
+    return result->fullFrameUs + BENCH_PARTIAL_WEIGHT * result->partialUs;
+}
+
+bool _storeConfig(const display_config_t *config)
+{
+    nvs_handle_t handle;
+    if (nvs_open(BENCH_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGE(TAG, "Unable to open NVS");
+        return false;
+    }
+
+    _benchStored_t stored = {
+        .version = BENCH_NVS_VERSION,
+        .config = *config,
+    };
+    esp_err_t err = nvs_set_blob(handle, BENCH_NVS_KEY, &stored, sizeof(stored));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Unable to store calibration: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
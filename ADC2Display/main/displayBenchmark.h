@@ -0,0 +1,89 @@
+/// \file		displayBenchmark.h
+///
+/// \brief	Display throughput benchmark and SPI/buffer auto-calibration
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_BENCHMARK_H
+#define DISPLAY_BENCHMARK_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include "tft_driver.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    display_config_t config;
+    uint32_t fullFrameUs;       // Average time to push one full frame
+    uint32_t partialUs;         // Average time to push one partial area
+    uint32_t fullFps;           // Full frames per second
+    uint32_t partialKpps;       // Partial fill rate, kilo pixels per second
+    bool stable;                // All transfers completed and the timing repeated
+} displayBenchmarkResult_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Measure one display configuration
+ *
+ * Brings the display up with \p config, pushes full frames and partial areas
+ * and tears the display down again. Must run before LVGL owns the display.
+ */
+bool displayBenchmarkMeasure(const display_config_t *config, displayBenchmarkResult_t *result);
+
+/**
+ * @brief Search pixel clocks, draw buffer sizes and queue depths
+ *
+ * The best stable configuration is stored in NVS and returned in \p best.
+ */
+bool displayBenchmarkCalibrate(display_config_t *best);
+
+/**
+ * @brief Measure \p config with 16 bpp RGB565 and 12 bpp RGB444 and log the gain
+ */
+bool displayBenchmarkComparePixelFormats(const display_config_t *config);
+
+/**
+ * @brief Small-area updates per second with and without the window cache
+ *
+ * Redraws one tile in place and walks a tile along a row, the two cases the
+ * cache helps with. Must run before LVGL owns the display.
+ */
+bool displayBenchmarkWindowCache(const display_config_t *config);
+
+/**
+ * @brief Load the configuration stored by the last calibration
+ */
+bool displayBenchmarkLoadConfig(display_config_t *config);
+
+/**
+ * @brief Compare a label redraw with a glyph atlas readout update
+ *
+ * Temporary widgets are created on \p parent and removed afterwards. Must be
+ * called from the task owning LVGL, once the display driver is registered.
+ */
+void displayBenchmarkReadout(lv_obj_t *parent);
+
+#endif // DISPLAY_BENCHMARK_H
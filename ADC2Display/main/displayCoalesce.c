@@ -0,0 +1,437 @@
+/// \file		displayCoalesce.c
+///
+/// \brief	Dirty rectangle coalescing between LVGL and the panel
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "tft_driver.h"
+#include "product_pins.h"
+#include "displayMem.h"
+#include "displayCoalesce.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+// The shadow holds one frame in any rotation, the tile grid is square so it
+// covers both the landscape and the portrait layout
+#define COALESCE_FRAME_PIXELS       (AMOLED_HEIGHT * AMOLED_WIDTH)
+#define COALESCE_MAX_RES            (AMOLED_HEIGHT > AMOLED_WIDTH ? AMOLED_HEIGHT : AMOLED_WIDTH)
+
+// Areas collected per frame; when full everything collapses into one box
+#define COALESCE_MAX_AREAS          16
+
+// Cost of opening a window (CASET, RASET and RAMWR with their parameters),
+// expressed in pixel data bytes that could have been sent in the same time
+#define COALESCE_SETUP_COST_BYTES   96
+
+#define COALESCE_TILE_SIZE          16
+#define COALESCE_MAX_TILES          ((COALESCE_MAX_RES + COALESCE_TILE_SIZE - 1) / COALESCE_TILE_SIZE)
+
+#define COALESCE_TRANS_TIMEOUT_MS   500
+#define COALESCE_REPORT_FRAMES      100
+
+#define COALESCE_MIN(a, b)          ((a) < (b) ? (a) : (b))
+#define COALESCE_MAX(a, b)          ((a) > (b) ? (a) : (b))
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+// Inclusive coordinates, like lv_area_t
+typedef struct {
+    int16_t x1;
+    int16_t y1;
+    int16_t x2;
+    int16_t y2;
+} _rect_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Bytes on the wire for one transfer of \p pixels
+ *
+ * In 12 bpp mode two pixels take 3 bytes and an odd last pixel 2.
+ */
+static uint32_t _bytes(uint32_t pixels);
+
+static uint32_t _cost(const _rect_t *rect);
+
+/**
+ * @brief Merge areas while the merged box is cheaper than sending both
+ */
+static void _mergeAreas(void);
+
+/**
+ * @brief Send a rectangle of the shadow frame through the staging buffers
+ */
+static void _sendRect(const _rect_t *rect);
+
+/**
+ * @brief Send only the tiles of a rectangle that changed since the last frame
+ *
+ * Runs of changed tiles on consecutive tile rows that span the same columns
+ * are sent as a single window.
+ */
+static void _sendChangedTiles(const _rect_t *rect);
+
+static uint32_t _hashTile(int tx, int ty);
+static void _report(void);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "coalesce";
+
+// Copy of what the panel shows (or is about to show)
+static uint16_t *shadow = NULL;
+static int horRes = AMOLED_HEIGHT;
+static int verRes = AMOLED_WIDTH;
+
+// Staging buffers are DMA capable and ping-ponged
+static uint16_t *staging[2] = { NULL, NULL };
+static uint32_t stagingSeq[2] = { 0, 0 };
+static bool stagingBusy[2] = { false, false };
+static uint32_t stagingPixels = 0;
+static int stagingIdx = 0;
+
+static _rect_t areas[COALESCE_MAX_AREAS];
+static int areaCount = 0;
+
+static uint32_t tileHash[COALESCE_MAX_TILES][COALESCE_MAX_TILES];
+static bool tileHashValid = false;
+
+static displayCoalesceStats_t stats;
+static displayCoalesceStats_t reportBase;
+
+static displayCoalesceSendCb_t sendCb = NULL;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+bool displayCoalesceInit(uint32_t pixels)
+{
+    // Only the staging buffers are read by the DMA
+    shadow = (uint16_t *)displayMemAlloc(COALESCE_FRAME_PIXELS * sizeof(uint16_t));
+    staging[0] = (uint16_t *)displayMemDmaAlloc(pixels * sizeof(uint16_t));
+    staging[1] = (uint16_t *)displayMemDmaAlloc(pixels * sizeof(uint16_t));
+
+    if (!shadow || !staging[0] || !staging[1]) {
+        ESP_LOGE(TAG, "No memory for the shadow frame");
+        displayMemFree(shadow);
+        displayMemFree(staging[0]);
+        displayMemFree(staging[1]);
+        shadow = staging[0] = staging[1] = NULL;
+        return false;
+    }
+    memset(shadow, 0, COALESCE_FRAME_PIXELS * sizeof(uint16_t));
+
+    stagingPixels = pixels;
+    areaCount = 0;
+    tileHashValid = false;
+    memset(&stats, 0, sizeof(stats));
+    memset(&reportBase, 0, sizeof(reportBase));
+    return true;
+}
+
+void displayCoalesceFlush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    const int w = area->x2 - area->x1 + 1;
+    const int h = area->y2 - area->y1 + 1;
+
+    // Keep the frame, LVGL can reuse its draw buffer straight away
+    for (int row = 0; row < h; row++) {
+        memcpy(&shadow[(area->y1 + row) * horRes + area->x1],
+               &color_map[row * w],
+               w * sizeof(uint16_t));
+    }
+    lv_disp_flush_ready(drv);
+
+    stats.bytesBefore += _bytes(w * h);
+    stats.transfersBefore++;
+
+    _rect_t rect = { area->x1, area->y1, area->x2, area->y2 };
+    if (DISPLAY_COALESCE_TILE_DIFF) {
+        // Whole tiles only, so a tile hash always describes what was sent
+        rect.x1 -= rect.x1 % COALESCE_TILE_SIZE;
+        rect.y1 -= rect.y1 % COALESCE_TILE_SIZE;
+        rect.x2 = COALESCE_MIN(rect.x2 | (COALESCE_TILE_SIZE - 1), horRes - 1);
+        rect.y2 = COALESCE_MIN(rect.y2 | (COALESCE_TILE_SIZE - 1), verRes - 1);
+    }
+    if (areaCount == COALESCE_MAX_AREAS) {
+        // Out of slots, collapse everything into the first one
+        for (int i = 1; i < areaCount; i++) {
+            areas[0].x1 = COALESCE_MIN(areas[0].x1, areas[i].x1);
+            areas[0].y1 = COALESCE_MIN(areas[0].y1, areas[i].y1);
+            areas[0].x2 = COALESCE_MAX(areas[0].x2, areas[i].x2);
+            areas[0].y2 = COALESCE_MAX(areas[0].y2, areas[i].y2);
+        }
+        areaCount = 1;
+    }
+    areas[areaCount++] = rect;
+
+    if (!lv_disp_flush_is_last(drv)) {
+        return;
+    }
+
+    _mergeAreas();
+    for (int i = 0; i < areaCount; i++) {
+        if (DISPLAY_COALESCE_TILE_DIFF) {
+            _sendChangedTiles(&areas[i]);
+        } else {
+            _sendRect(&areas[i]);
+        }
+    }
+    areaCount = 0;
+    tileHashValid = DISPLAY_COALESCE_TILE_DIFF;
+    stats.frames++;
+
+    if (stats.frames - reportBase.frames >= COALESCE_REPORT_FRAMES) {
+        _report();
+    }
+}
+
+void displayCoalesceInvalidate(void)
+{
+    tileHashValid = false;
+}
+
+void displayCoalesceSetResolution(int hor, int ver)
+{
+    // Areas collected in the old layout are meaningless in the new one
+    horRes = hor;
+    verRes = ver;
+    areaCount = 0;
+    tileHashValid = false;
+}
+
+void displayCoalesceSetSendCb(displayCoalesceSendCb_t cb)
+{
+    sendCb = cb;
+}
+
+void displayCoalesceBlit(const lv_area_t *area, const lv_color_t *colors)
+{
+    if (!shadow || area->x1 < 0 || area->y1 < 0 || area->x2 >= horRes || area->y2 >= verRes) {
+        return;
+    }
+
+    const int w = area->x2 - area->x1 + 1;
+    const int h = area->y2 - area->y1 + 1;
+    for (int row = 0; row < h; row++) {
+        memcpy(&shadow[(area->y1 + row) * horRes + area->x1], &colors[row * w], w * sizeof(uint16_t));
+    }
+    // The panel already shows these pixels, so the tiles under the blit are
+    // rehashed: LVGL drawing its background over them later counts as a change
+    if (tileHashValid) {
+        for (int ty = area->y1 / COALESCE_TILE_SIZE; ty <= area->y2 / COALESCE_TILE_SIZE; ty++) {
+            for (int tx = area->x1 / COALESCE_TILE_SIZE; tx <= area->x2 / COALESCE_TILE_SIZE; tx++) {
+                tileHash[ty][tx] = _hashTile(tx, ty);
+            }
+        }
+    }
+}
+
+void displayCoalesceGetStats(displayCoalesceStats_t *out)
+{
+    *out = stats;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+uint32_t _bytes(uint32_t pixels)
+{
+    if (display_get_config()->bits_per_pixel == 12) {
+        return pixels / 2 * 3 + (pixels & 1) * 2;
+    }
+    return pixels * sizeof(uint16_t);
+}
+
+uint32_t _cost(const _rect_t *rect)
+{
+    return _bytes((uint32_t)(rect->x2 - rect->x1 + 1) * (rect->y2 - rect->y1 + 1)) + COALESCE_SETUP_COST_BYTES;
+}
+
+void _mergeAreas(void)
+{
+    bool merged = true;
+
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < areaCount && !merged; i++) {
+            for (int j = i + 1; j < areaCount; j++) {
+                _rect_t box = {
+                    COALESCE_MIN(areas[i].x1, areas[j].x1),
+                    COALESCE_MIN(areas[i].y1, areas[j].y1),
+                    COALESCE_MAX(areas[i].x2, areas[j].x2),
+                    COALESCE_MAX(areas[i].y2, areas[j].y2),
+                };
+                if (_cost(&box) <= _cost(&areas[i]) + _cost(&areas[j])) {
+                    areas[i] = box;
+                    areas[j] = areas[--areaCount];
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void _sendRect(const _rect_t *rect)
+{
+    const int w = rect->x2 - rect->x1 + 1;
+    const int bandRows = COALESCE_MAX(1, (int)(stagingPixels / w));
+
+    if (sendCb) {
+        const lv_area_t area = { rect->x1, rect->y1, rect->x2, rect->y2 };
+        sendCb(&area);
+    }
+
+    for (int y = rect->y1; y <= rect->y2; y += bandRows) {
+        const int rows = COALESCE_MIN(bandRows, rect->y2 - y + 1);
+        const int idx = stagingIdx;
+        uint16_t *buf = staging[idx];
+
+        // The other buffer may still be on the wire, this one must not
+        if (stagingBusy[idx] && !display_wait_trans_done(stagingSeq[idx], COALESCE_TRANS_TIMEOUT_MS)) {
+            ESP_LOGW(TAG, "Transfer timed out");
+        }
+
+        for (int row = 0; row < rows; row++) {
+            memcpy(&buf[row * w], &shadow[(y + row) * horRes + rect->x1], w * sizeof(uint16_t));
+        }
+
+        stagingBusy[idx] = display_push_colors(rect->x1, y, rect->x2 + 1, y + rows, buf) == ESP_OK;
+        stagingSeq[idx] = display_get_trans_queued();
+        stagingIdx ^= 1;
+
+        stats.bytesAfter += _bytes(w * rows);
+        stats.transfersAfter++;
+    }
+}
+
+void _sendChangedTiles(const _rect_t *rect)
+{
+    const int tx1 = rect->x1 / COALESCE_TILE_SIZE;
+    const int tx2 = rect->x2 / COALESCE_TILE_SIZE;
+    const int ty1 = rect->y1 / COALESCE_TILE_SIZE;
+    const int ty2 = rect->y2 / COALESCE_TILE_SIZE;
+
+    // Runs of changed tiles carried over from the previous tile row
+    _rect_t pending[COALESCE_MAX_TILES];
+    int pendingCount = 0;
+
+    for (int ty = ty1; ty <= ty2 + 1; ty++) {
+        _rect_t runs[COALESCE_MAX_TILES];
+        int runCount = 0;
+
+        if (ty <= ty2) {
+            int runStart = -1;
+            for (int tx = tx1; tx <= tx2 + 1; tx++) {
+                bool changed = false;
+                if (tx <= tx2) {
+                    uint32_t hash = _hashTile(tx, ty);
+                    changed = !tileHashValid || hash != tileHash[ty][tx];
+                    tileHash[ty][tx] = hash;
+                }
+                if (changed && runStart < 0) {
+                    runStart = tx;
+                } else if (!changed && runStart >= 0) {
+                    runs[runCount++] = (_rect_t) {
+                        COALESCE_MAX(rect->x1, runStart * COALESCE_TILE_SIZE),
+                        COALESCE_MAX(rect->y1, ty * COALESCE_TILE_SIZE),
+                        COALESCE_MIN(rect->x2, tx * COALESCE_TILE_SIZE - 1),
+                        COALESCE_MIN(rect->y2, (ty + 1) * COALESCE_TILE_SIZE - 1),
+                    };
+                    runStart = -1;
+                }
+            }
+        }
+
+        // Extend pending runs with identical columns, send the others
+        int kept = 0;
+        for (int p = 0; p < pendingCount; p++) {
+            bool extended = false;
+            for (int r = 0; r < runCount; r++) {
+                if (runs[r].x1 == pending[p].x1 && runs[r].x2 == pending[p].x2) {
+                    pending[p].y2 = runs[r].y2;
+                    runs[r] = runs[--runCount];
+                    extended = true;
+                    break;
+                }
+            }
+            if (extended) {
+                pending[kept++] = pending[p];
+            } else {
+                _sendRect(&pending[p]);
+            }
+        }
+        pendingCount = kept;
+        for (int r = 0; r < runCount; r++) {
+            pending[pendingCount++] = runs[r];
+        }
+    }
+}
+
+uint32_t _hashTile(int tx, int ty)
+{
+    const int x1 = tx * COALESCE_TILE_SIZE;
+    const int y1 = ty * COALESCE_TILE_SIZE;
+    const int x2 = COALESCE_MIN(x1 + COALESCE_TILE_SIZE, horRes);
+    const int y2 = COALESCE_MIN(y1 + COALESCE_TILE_SIZE, verRes);
+
+    // FNV-1a over the tile pixels
+    uint32_t hash = 2166136261u;
+    for (int y = y1; y < y2; y++) {
+        const uint16_t *row = &shadow[y * horRes];
+        for (int x = x1; x < x2; x++) {
+            hash = (hash ^ row[x]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void _report(void)
+{
+    const uint32_t frames = stats.frames - reportBase.frames;
+
+    ESP_LOGI(TAG, "frames=%lu before=%lu B/%lu xfers after=%lu B/%lu xfers (per frame)",
+             (unsigned long)frames,
+             (unsigned long)((stats.bytesBefore - reportBase.bytesBefore) / frames),
+             (unsigned long)((stats.transfersBefore - reportBase.transfersBefore) / frames),
+             (unsigned long)((stats.bytesAfter - reportBase.bytesAfter) / frames),
+             (unsigned long)((stats.transfersAfter - reportBase.transfersAfter) / frames));
+    reportBase = stats;
+}
@@ -0,0 +1,92 @@
+/// \file		displayCoalesce.h
+///
+/// \brief	Dirty rectangle coalescing between LVGL and the panel
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_COALESCE_H
+#define DISPLAY_COALESCE_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t frames;
+    uint32_t bytesBefore;       // Bytes LVGL asked to flush, at the panel pixel format
+    uint32_t transfersBefore;   // Flush calls made by LVGL
+    uint32_t bytesAfter;        // Bytes actually sent to the panel
+    uint32_t transfersAfter;    // Windows actually sent to the panel
+} displayCoalesceStats_t;
+
+/**
+ * @brief Called for every window sent to the panel, merged areas included
+ */
+typedef void (*displayCoalesceSendCb_t)(const lv_area_t *area);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Allocate the shadow frame and staging buffers
+ *
+ * @param stagingPixels Size of each DMA staging buffer, in pixels
+ */
+bool displayCoalesceInit(uint32_t stagingPixels);
+
+/**
+ * @brief LVGL flush callback
+ *
+ * The area is copied into the shadow frame and released to LVGL right away.
+ * On the last flush of a frame the collected areas are merged and sent.
+ */
+void displayCoalesceFlush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
+
+/**
+ * @brief Forget the tile hashes so the next frame is sent in full
+ */
+void displayCoalesceInvalidate(void);
+
+/**
+ * @brief Follow a display rotation
+ *
+ * The shadow frame keeps its size, only its row length changes. Must be
+ * called between frames, LVGL then redraws the whole screen.
+ */
+void displayCoalesceSetResolution(int hor, int ver);
+
+void displayCoalesceSetSendCb(displayCoalesceSendCb_t cb);
+
+/**
+ * @brief Record pixels sent to the panel without going through LVGL
+ *
+ * Nothing is sent. The shadow frame is updated so later windows overlapping
+ * \p area resend these pixels instead of what LVGL last drew there.
+ */
+void displayCoalesceBlit(const lv_area_t *area, const lv_color_t *colors);
+
+void displayCoalesceGetStats(displayCoalesceStats_t *stats);
+
+#endif // DISPLAY_COALESCE_H
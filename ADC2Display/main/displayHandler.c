@@ -18,7 +18,6 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/semphr.h"
 #include "esp_timer.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
@@ -30,6 +29,17 @@
 #include "lvgl.h"
 #include "tft_driver.h"
 #include "product_pins.h"
+#include "displayBenchmark.h"
+#include "displayCoalesce.h"
+#include "displayStats.h"
+#include "numericReadout.h"
+#include "displayServer.h"
+#include "dataBinding.h"
+#include "backlight.h"
+#include "displayPower.h"
+#include "displayMem.h"
+#include "displayImage.h"
+#include "assets.h"
 
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
@@ -37,10 +47,8 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 #define LVGL_TICK_PERIOD_MS 2
-#define LVGL_TASK_MAX_DELAY_MS 500
-#define LVGL_TASK_MIN_DELAY_MS 1
-#define LVGL_TASK_STACK_SIZE (4 * 1024)
-#define LVGL_TASK_PRIORITY 2
+#define ADC_READOUT_CELLS 5
+#define ADC_READOUT_MAX_HZ 20
 
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
@@ -48,6 +56,11 @@
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 
+// Data binding slots
+enum {
+    DATA_SLOT_ADC,
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 //                        LOCAL FUNCTIONS PROTOTYPES                        //
@@ -55,14 +68,24 @@
 //////////////////////////////////////////////////////////////////////////////
 
 /**
- * @brief Task to update LVGL
- *
- * This task is responsible to periodically call lv_task_handler() to update
- * the LVGL library.
- *
- * @param arg A pointer to the lvglTask structure
+ * @brief Build the UI, first thing run by the display server task
+ */
+static void _uiStart(void);
+
+/**
+ * @brief Called by the display server after every lv_timer_handler()
+ */
+static void _uiFrame(void);
+
+/**
+ * @brief Power state and posted values, before every frame and while paused
  */
-static void lvglTask(void *arg);
+static void _uiUpdate(void);
+
+/**
+ * @brief Stop the LVGL tick while the display is off
+ */
+static void _powerPause(bool paused);
 
 /**
  * @brief Flush the content of the internal graphic buffer(s) to the display
@@ -90,7 +113,27 @@ static void _lvglFlushCallback(lv_disp_drv_t *drv, const lv_area_t *area, lv_col
  */
 static void _lvglTick(void *arg);
 
+/**
+ * @brief Tell LVGL the flushed area has left the draw buffer
+ *
+ * Called from the SPI ISR for every color transfer, readout blits included.
+ * The draw buffer is only released once the transfer queued by the pending
+ * flush is done. With coalescing it was already released, only the transfer
+ * is counted.
+ *
+ * @param arg The LVGL display driver
+ */
+static void _lvglFlushReady(void *arg);
+
+/**
+ * @brief Switch panel orientation and LVGL resolution, run in the server task
+ *
+ * Between frames, so no area of the old layout is left half sent.
+ */
+static void _applyRotation(void *arg);
+
 static void _configureLabel(void);
+static void _readoutApply(void *ctx, const dataBindingValue_t *value);
 
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
@@ -100,19 +143,24 @@ static void _configureLabel(void);
 
 static const char *TAG = "lvgl";
 
-// Mutex for lvgl
-static SemaphoreHandle_t lvglMutex = NULL;
-static SemaphoreHandle_t adcDataMutex;
-
 // Contains callback functions
-lv_disp_drv_t disp_drv;
+static lv_disp_drv_t disp_drv;
 
 // Contains internal graphic buffer(s) called draw buffer(s)
 static lv_disp_draw_buf_t disp_buf;
 
+// Flushes go through the coalescer instead of straight to the panel
+static bool coalesce = false;
+
+// Transfer carrying the draw buffer LVGL is waiting for
+static volatile uint32_t flushSeq = 0;
+static volatile bool flushPending = false;
+
+static esp_timer_handle_t lvgl_tick_timer = NULL;
+
 // Plot Data
-static int adcData;
 static lv_obj_t *labelPlot;
+static numericReadout_t *adcReadout;
 
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
@@ -123,31 +171,88 @@ static lv_obj_t *labelPlot;
 void displayHandlerInit(void)
 {
     ESP_LOGI(TAG, "------ Initialize DISPLAY ------ ");
-    display_init();
+    display_config_t config = DISPLAY_CONFIG_DEFAULT();
+    if (DISPLAY_BENCHMARK_ON_BOOT) {
+        displayBenchmarkCalibrate(&config);
+    } else {
+        displayBenchmarkLoadConfig(&config);
+    }
+    config.bits_per_pixel = DISPLAY_BITS_PER_PIXEL;
+    if (DISPLAY_WINDOW_BENCHMARK) {
+        displayBenchmarkWindowCache(&config);
+    }
+    if (display_init_with_config(&config) != ESP_OK) {
+        ESP_LOGW(TAG, "Display configuration rejected, falling back to defaults");
+        display_init();
+    }
+    if (display_set_rotation(DISPLAY_ROTATION) != ESP_OK) {
+        ESP_LOGW(TAG, "Rotation %d rejected", DISPLAY_ROTATION * 90);
+    }
+    uint16_t horRes, verRes;
+    display_get_resolution(&horRes, &verRes);
+    const uint32_t bufPixels = AMOLED_HEIGHT * display_get_config()->draw_buf_lines;
+
+#ifdef ASSET_SPLASH
+    // images/splash.png, on the panel before the backlight fades in
+    displayImageDraw(&splash, splash.width < horRes ? (horRes - splash.width) / 2 : 0,
+                     splash.height < verRes ? (verRes - splash.height) / 2 : 0);
+#endif
+
+    backlightConfig_t backlightConfig = BACKLIGHT_CONFIG_DEFAULT();
+    if (backlightInit(&backlightConfig) != ESP_OK) {
+        ESP_LOGW(TAG, "Backlight control unavailable");
+    }
+
+    const displayPowerConfig_t powerConfig = {
+        .dimTimeoutMs = DISPLAY_DIM_TIMEOUT_MS,
+        .sleepTimeoutMs = DISPLAY_SLEEP_TIMEOUT_MS,
+        .offTimeoutMs = DISPLAY_OFF_TIMEOUT_MS,
+        .buttons = { BOARD_BUTTON_1, BOARD_BUTTON_2 },
+        .onPause = _powerPause,
+    };
+    if (displayPowerInit(&powerConfig) != ESP_OK) {
+        ESP_LOGW(TAG, "Buttons unavailable, the display wakes on LVGL input only");
+    }
+
+    // With coalescing the flush callback releases the draw buffer itself
+    coalesce = DISPLAY_COALESCE && displayCoalesceInit(bufPixels);
+    display_set_flush_ready_cb(_lvglFlushReady, &disp_drv);
+    if (coalesce) {
+        // Merged windows can cover the readouts even if LVGL didn't draw there
+        displayCoalesceSetSendCb(numericReadoutAreaFlushed);
+        displayCoalesceSetResolution(horRes, verRes);
+        // Blits bypass the coalescer, the shadow frame must still see them
+        numericReadoutSetBlitCb(displayCoalesceBlit);
+    }
 
     ESP_LOGI(TAG, "------ Initialize LVGL library ------ ");
     lv_init();
+    displayImageRegisterDecoder();
 
     // Alloc draw buffers used by LVGL
     // it's recommended to choose the size of the draw buffer(s) to be at least 1/10 screen sized
-    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(AMOLED_HEIGHT * 20 * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    lv_color_t *buf2 = (lv_color_t *) heap_caps_malloc(AMOLED_HEIGHT * 20 * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t *buf1 = (lv_color_t *)displayMemDmaAlloc(bufPixels * sizeof(lv_color_t));
+    lv_color_t *buf2 = (lv_color_t *)displayMemDmaAlloc(bufPixels * sizeof(lv_color_t));
     assert(buf1);
     assert(buf2);
 
     // Display Buffer Initialization
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, AMOLED_HEIGHT * 20);
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, bufPixels);
 
     // Display Driver Initizalization
     ESP_LOGI(TAG, "Register display driver to LVGL");
     lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = AMOLED_HEIGHT;
-    disp_drv.ver_res = AMOLED_WIDTH;
+    disp_drv.hor_res = horRes;
+    disp_drv.ver_res = verRes;
     disp_drv.flush_cb = _lvglFlushCallback;
     disp_drv.draw_buf = &disp_buf;
     disp_drv.full_refresh = DISPLAY_FULLRESH;
     lv_disp_drv_register(&disp_drv);
 
+    if (DISPLAY_STATS) {
+        displayStatsInit(DISPLAY_STATS_OVERLAY);
+    }
+
     // Timer initialization
     // Create a timer to periodically call lv_tick_inc
     // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
@@ -159,41 +264,27 @@ void displayHandlerInit(void)
         .name = "lvgl_tick",
         .skip_unhandled_events = false
     };
-    esp_timer_handle_t lvgl_tick_timer = NULL;
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
     ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000));
 
-    // Mutex for lvgl
-    lvglMutex = xSemaphoreCreateRecursiveMutex();
-    assert(lvglMutex);
-
-    // Mutex for adc data
-    adcDataMutex = xSemaphoreCreateMutex();
-    assert(adcDataMutex);
-
-    // Task Creation
-    ESP_LOGI(TAG, "Create LVGL task");
-    xTaskCreate(lvglTask, "LVGL", LVGL_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
-}
-
-bool lvglLock(int timeout_ms)
-{
-    // Convert timeout in milliseconds to FreeRTOS ticks
-    // If `timeout_ms` is set to -1, the program will block until the condition is met
-    const TickType_t timeout_ticks = (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
-    return xSemaphoreTakeRecursive(lvglMutex, timeout_ticks) == pdTRUE;
+    // From here on LVGL belongs to the display server task, other tasks
+    // post updates to it
+    const displayServerConfig_t serverConfig = {
+        .onStart = _uiStart,
+        .onUpdate = _uiUpdate,
+        .onFrame = _uiFrame,
+    };
+    displayServerStart(&serverConfig);
 }
 
-void lvglUnlock(void)
+void displayHandlerUpdateData(int value) 
 {
-    xSemaphoreGiveRecursive(lvglMutex);
+    dataBindingPublishInt(DATA_SLOT_ADC, value);
 }
 
-void displayHandlerUpdateData(int value) 
+bool displayHandlerSetRotation(display_rotation_t rotation)
 {
-    xSemaphoreTake(adcDataMutex, portMAX_DELAY);
-    adcData = value;
-    xSemaphoreGive(adcDataMutex);
+    return displayServerCall(_applyRotation, (void *)(uintptr_t)rotation);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -201,29 +292,42 @@ void displayHandlerUpdateData(int value)
 //                              LOCAL FUNCTIONS                             //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
-void lvglTask(void *arg)
+void _uiStart(void)
 {
-    ESP_LOGI(TAG, "Starting LVGL task");
+    if (DISPLAY_READOUT_BENCHMARK) {
+        displayBenchmarkReadout(lv_scr_act());
+    }
     _configureLabel();
 
-    // Update label
-    char buf[32];
-
-    while (1) {
-        // Lock the mutex due to the LVGL APIs are not thread-safe
-        if (lvglLock(-1)) {
-            lv_timer_handler();     // Process LVGL tasks
+    dataBindingBind(DATA_SLOT_ADC, _readoutApply, adcReadout, ADC_READOUT_MAX_HZ);
+}
 
-            xSemaphoreTake(adcDataMutex, portMAX_DELAY);
-            snprintf(buf, sizeof(buf), "ADC Value: %d", adcData);
-            xSemaphoreGive(adcDataMutex);
+void _uiFrame(void)
+{
+    // Only the digits that changed are sent to the panel
+    numericReadoutRefresh();
+    displayMemProcess();
+}
 
-            lv_label_set_text(labelPlot, buf);
+void _uiUpdate(void)
+{
+    displayPowerProcess();
+    dataBindingProcess();
+}
 
-            lvglUnlock();           // Release the mutex
-        }
+void _powerPause(bool paused)
+{
+    if (paused) {
+        esp_timer_stop(lvgl_tick_timer);
+    } else {
+        esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000);
+    }
+}
 
-        vTaskDelay(pdMS_TO_TICKS(LVGL_TASK_MAX_DELAY_MS));
+void _readoutApply(void *ctx, const dataBindingValue_t *value)
+{
+    if (value->type == DATA_SLOT_INT) {
+        numericReadoutSetValue((numericReadout_t *)ctx, value->i);
     }
 }
 
@@ -234,20 +338,78 @@ void _configureLabel(void)
 
     // Configure label
     labelPlot = lv_label_create(screen);
-    lv_obj_align(labelPlot, LV_ALIGN_CENTER, 0, 0); 
-    
+    lv_label_set_text(labelPlot, "ADC Value:");
+    lv_obj_align(labelPlot, LV_ALIGN_CENTER, -ADC_READOUT_CELLS * 6, 0);
+
+    // The value is a glyph atlas readout next to the static text
+    adcReadout = numericReadoutCreate(screen,
+                                      lv_obj_get_style_text_font(labelPlot, LV_PART_MAIN),
+                                      ADC_READOUT_CELLS, 0,
+                                      lv_obj_get_style_text_color(labelPlot, LV_PART_MAIN),
+                                      lv_obj_get_style_bg_color(screen, LV_PART_MAIN));
+    assert(adcReadout);
+    lv_obj_align_to(numericReadoutGetObj(adcReadout), labelPlot, LV_ALIGN_OUT_RIGHT_MID, 4, 0);
 }
 
 void _lvglFlushCallback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
+    displayStatsFlushBegin(lv_disp_flush_is_last(drv));
+    if (coalesce) {
+        displayCoalesceFlush(drv, area, color_map);
+        displayStatsFlushDone();
+        return;
+    }
+
+    numericReadoutAreaFlushed(area);
     int offsetx1 = area->x1;
     int offsetx2 = area->x2;
     int offsety1 = area->y1;
     int offsety2 = area->y2;
-    display_push_colors(offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, (uint16_t *)color_map);
+    // Only this task queues transfers, so the next sequence number is ours.
+    // Set before the push, the transfer may be done before it returns.
+    flushSeq = display_get_trans_queued() + 1;
+    flushPending = true;
+    if (display_push_colors(offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, (uint16_t *)color_map) != ESP_OK) {
+        flushPending = false;
+        displayStatsFlushDone();
+        lv_disp_flush_ready(drv);
+    }
 }
 
 void _lvglTick(void *arg)
 {
     lv_tick_inc(LVGL_TICK_PERIOD_MS);
 }
+
+void _lvglFlushReady(void *arg)
+{
+    displayStatsDmaDone();
+    if (!coalesce && flushPending && (int32_t)(display_get_trans_done() - flushSeq) >= 0) {
+        flushPending = false;
+        displayStatsFlushDone();
+        lv_disp_flush_ready((lv_disp_drv_t *)arg);
+    }
+}
+
+void _applyRotation(void *arg)
+{
+    const display_rotation_t rotation = (display_rotation_t)(uintptr_t)arg;
+    if (rotation == display_get_rotation()) {
+        return;
+    }
+    if (display_set_rotation(rotation) != ESP_OK) {
+        return;
+    }
+
+    uint16_t horRes, verRes;
+    display_get_resolution(&horRes, &verRes);
+    if (coalesce) {
+        displayCoalesceSetResolution(horRes, verRes);
+    }
+
+    // Resizes the screens, realigns their children and invalidates everything.
+    // The draw buffers hold the same number of pixels in either layout.
+    disp_drv.hor_res = horRes;
+    disp_drv.ver_res = verRes;
+    lv_disp_drv_update(lv_disp_get_default(), &disp_drv);
+}
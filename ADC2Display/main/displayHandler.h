@@ -22,6 +22,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
 #include "lvgl.h"
+#include "tft_driver.h"
 
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
@@ -36,8 +37,11 @@
 //////////////////////////////////////////////////////////////////////////////
 
 void displayHandlerInit(void);
-bool lvglLock(int timeout_ms);
-void lvglUnlock(void);
 void displayHandlerUpdateData(lv_coord_t value) ;
 
+/**
+ * @brief Rotate the UI, applied by the display server before the next frame
+ */
+bool displayHandlerSetRotation(display_rotation_t rotation);
+
 #endif // DISPLAY_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,259 @@
+/// \file		displayImage.c
+///
+/// \brief	RLE compressed RGB565 images, decoded line by line
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "lvgl.h"
+#include "tft_driver.h"
+#include "product_pins.h"
+#include "displayMem.h"
+#include "displayImage.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#if LV_COLOR_DEPTH != 16
+#error "displayImage only decodes to RGB565"
+#endif
+
+#define IMAGE_RUN_BIT               0x80
+#define IMAGE_COUNT_MASK            0x7f
+
+// Each of the two DMA buffers holds this many pixels, whole lines only
+#define IMAGE_BAND_PIXELS           (AMOLED_HEIGHT * 10)
+
+#define IMAGE_TRANS_TIMEOUT_MS      500
+
+#define IMAGE_MIN(a, b)             ((a) < (b) ? (a) : (b))
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Bring decoded pixels to the byte order of lv_color_t
+ *
+ * The panel driver and LVGL both expect it, and it only differs from the
+ * image when the asset was generated for the other LV_COLOR_16_SWAP setting.
+ */
+static void _matchColorOrder(const displayImage_t *image, uint16_t *pixels, uint32_t count);
+
+static const displayImage_t *_fromSource(const void *src);
+static lv_res_t _decoderInfo(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header);
+static lv_res_t _decoderOpen(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc);
+static lv_res_t _decoderReadLine(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc,
+                                 lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t *buf);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayImage";
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+bool displayImageDecodeLine(const displayImage_t *image, uint16_t line, uint16_t x, uint16_t len, uint16_t *dst)
+{
+    if (line >= image->height || x + len > image->width) {
+        return false;
+    }
+
+    const uint8_t *p = image->data + image->lines[line];
+    const uint8_t *end = image->data + (line + 1 < image->height ? image->lines[line + 1] : image->size);
+    uint32_t skip = x;
+
+    while (len && p < end) {
+        const uint8_t control = *p++;
+        uint32_t count = (control & IMAGE_COUNT_MASK) + 1;
+        const bool run = control & IMAGE_RUN_BIT;
+        const uint32_t bytes = run ? sizeof(uint16_t) : count * sizeof(uint16_t);
+
+        if (p + bytes > end) {
+            break;
+        }
+        if (skip >= count) {
+            skip -= count;
+            p += bytes;
+            continue;
+        }
+
+        // Pixels are kept in their stored byte order, hence the memcpy
+        const uint32_t n = IMAGE_MIN(count - skip, len);
+        if (run) {
+            uint16_t pixel;
+            memcpy(&pixel, p, sizeof(pixel));
+            for (uint32_t i = 0; i < n; i++) {
+                dst[i] = pixel;
+            }
+        } else {
+            memcpy(dst, p + skip * sizeof(uint16_t), n * sizeof(uint16_t));
+        }
+        dst += n;
+        len -= n;
+        skip = 0;
+        p += bytes;
+    }
+
+    return len == 0;
+}
+
+esp_err_t displayImageDraw(const displayImage_t *image, uint16_t x, uint16_t y)
+{
+    uint16_t horRes, verRes;
+    display_get_resolution(&horRes, &verRes);
+    ESP_RETURN_ON_FALSE(x < horRes && y < verRes, ESP_ERR_INVALID_ARG, TAG, "image out of screen");
+
+    const uint16_t w = IMAGE_MIN(image->width, horRes - x);
+    const uint16_t h = IMAGE_MIN(image->height, verRes - y);
+    const uint16_t bandLines = IMAGE_MIN(h, IMAGE_BAND_PIXELS / w);
+
+    uint16_t *buf[2];
+    buf[0] = (uint16_t *)displayMemDmaAlloc(bandLines * w * sizeof(uint16_t));
+    buf[1] = (uint16_t *)displayMemDmaAlloc(bandLines * w * sizeof(uint16_t));
+    uint32_t seq[2] = { 0, 0 };
+    bool busy[2] = { false, false };
+
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(buf[0] && buf[1], ESP_ERR_NO_MEM, done, TAG, "no mem for image buffers");
+
+    for (uint16_t row = 0, idx = 0; row < h; row += bandLines, idx ^= 1) {
+        const uint16_t lines = IMAGE_MIN(bandLines, h - row);
+
+        // The other buffer may still be on the wire, this one must not
+        if (busy[idx] && !display_wait_trans_done(seq[idx], IMAGE_TRANS_TIMEOUT_MS)) {
+            ESP_LOGW(TAG, "Transfer timed out");
+        }
+        for (uint16_t i = 0; i < lines; i++) {
+            uint16_t *dst = &buf[idx][i * w];
+            ESP_GOTO_ON_FALSE(displayImageDecodeLine(image, row + i, 0, w, dst), ESP_ERR_INVALID_SIZE, done, TAG,
+                              "corrupt image line %u", row + i);
+            _matchColorOrder(image, dst, w);
+        }
+
+        ESP_GOTO_ON_ERROR(display_push_colors(x, y + row, x + w, y + row + lines, buf[idx]), done, TAG,
+                          "push failed");
+        busy[idx] = true;
+        seq[idx] = display_get_trans_queued();
+    }
+
+done:
+    // The buffers are freed only once the DMA is done with them
+    for (int i = 0; i < 2; i++) {
+        if (busy[i] && !display_wait_trans_done(seq[i], IMAGE_TRANS_TIMEOUT_MS)) {
+            ESP_LOGW(TAG, "Transfer timed out");
+        }
+        displayMemFree(buf[i]);
+    }
+    return ret;
+}
+
+void displayImageRegisterDecoder(void)
+{
+    lv_img_decoder_t *decoder = lv_img_decoder_create();
+    if (!decoder) {
+        ESP_LOGE(TAG, "No memory for the image decoder");
+        return;
+    }
+    lv_img_decoder_set_info_cb(decoder, _decoderInfo);
+    lv_img_decoder_set_open_cb(decoder, _decoderOpen);
+    lv_img_decoder_set_read_line_cb(decoder, _decoderReadLine);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _matchColorOrder(const displayImage_t *image, uint16_t *pixels, uint32_t count)
+{
+    if (image->swapped == (bool)LV_COLOR_16_SWAP) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        pixels[i] = (uint16_t)((pixels[i] >> 8) | (pixels[i] << 8));
+    }
+}
+
+const displayImage_t *_fromSource(const void *src)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) {
+        return NULL;
+    }
+    const lv_img_dsc_t *dsc = (const lv_img_dsc_t *)src;
+    if (dsc->header.cf != LV_IMG_CF_USER_ENCODED_0) {
+        return NULL;
+    }
+    return (const displayImage_t *)dsc->data;
+}
+
+lv_res_t _decoderInfo(lv_img_decoder_t *decoder, const void *src, lv_img_header_t *header)
+{
+    LV_UNUSED(decoder);
+    const displayImage_t *image = _fromSource(src);
+    if (!image) {
+        return LV_RES_INV;
+    }
+
+    // Decoded lines are plain lv_color_t
+    header->always_zero = 0;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    header->w = image->width;
+    header->h = image->height;
+    return LV_RES_OK;
+}
+
+lv_res_t _decoderOpen(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc)
+{
+    LV_UNUSED(decoder);
+    if (!_fromSource(dsc->src)) {
+        return LV_RES_INV;
+    }
+
+    // No decoded copy, LVGL falls back to reading the lines it draws
+    dsc->img_data = NULL;
+    return LV_RES_OK;
+}
+
+lv_res_t _decoderReadLine(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc,
+                          lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t *buf)
+{
+    LV_UNUSED(decoder);
+    const displayImage_t *image = _fromSource(dsc->src);
+    if (!image || !displayImageDecodeLine(image, y, x, len, (uint16_t *)buf)) {
+        return LV_RES_INV;
+    }
+    _matchColorOrder(image, (uint16_t *)buf, len);
+    return LV_RES_OK;
+}
@@ -0,0 +1,92 @@
+/// \file		displayImage.h
+///
+/// \brief	RLE compressed RGB565 images, decoded line by line
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_IMAGE_H
+#define DISPLAY_IMAGE_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Image generated by tools/img2rgb565.py
+ *
+ * Pixels are RGB565, already byte swapped when LV_COLOR_16_SWAP is set, so
+ * they go to the panel as they are. Every line is encoded on its own and
+ * \p lines holds the offset of each one in \p data. A line is a sequence of
+ * packets starting with a control byte:
+ *  - bit 7 set:   a run, the next pixel repeated (control & 0x7f) + 1 times
+ *  - bit 7 clear: (control + 1) literal pixels follow
+ */
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    bool swapped;
+    const uint32_t *lines;
+    const uint8_t *data;
+    uint32_t size;
+} displayImage_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Decode \p len pixels of \p line, starting at column \p x
+ *
+ * @return false when the line is out of range or its data is corrupt
+ */
+bool displayImageDecodeLine(const displayImage_t *image, uint16_t line, uint16_t x, uint16_t len, uint16_t *dst);
+
+/**
+ * @brief Send an image straight to the panel, without LVGL
+ *
+ * Lines are decoded into two small DMA buffers which are sent in turn, the
+ * image is never held decoded in RAM. Meant for splash screens drawn before
+ * LVGL starts.
+ */
+esp_err_t displayImageDraw(const displayImage_t *image, uint16_t x, uint16_t y);
+
+/**
+ * @brief Register the LVGL decoder for LV_IMG_CF_USER_ENCODED_0 images
+ *
+ * The generated lv_img_dsc_t of each image can then be used with
+ * lv_img_set_src(). LVGL reads it line by line into its draw buffer.
+ */
+void displayImageRegisterDecoder(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_IMAGE_H
@@ -0,0 +1,222 @@
+/// \file		displayMem.c
+///
+/// \brief	Memory of the display stack: LVGL pool, DMA and bulk buffers
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "displayMem.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define MEM_MAX_BUFFERS             16
+#define MEM_LOG_PERIOD_US           (10 * 1000 * 1000)
+
+#define MEM_CAPS_DMA                (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+#define MEM_CAPS_PSRAM              (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define MEM_CAPS_INTERNAL           (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    void *ptr;
+    uint32_t size;
+    displayMemUsage_t *usage;
+} _buffer_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Account a new buffer, or a failure when \p ptr is NULL
+ */
+static void _track(void *ptr, size_t size, displayMemUsage_t *usage);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayMem";
+
+static portMUX_TYPE memLock = portMUX_INITIALIZER_UNLOCKED;
+
+static _buffer_t buffers[MEM_MAX_BUFFERS];
+static displayMemUsage_t dmaUsage;
+static displayMemUsage_t bulkUsage;
+
+static bool poolInPsram = false;
+static uint32_t poolSize = 0;
+
+static int64_t lastLogUs = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void *displayMemPoolAlloc(size_t size)
+{
+    void *pool = heap_caps_malloc_prefer(size, 2, MEM_CAPS_PSRAM, MEM_CAPS_INTERNAL);
+    if (!pool) {
+        ESP_LOGE(TAG, "No memory for the %u byte LVGL pool", (unsigned)size);
+        return NULL;
+    }
+
+    poolInPsram = esp_ptr_external_ram(pool);
+    poolSize = size;
+    ESP_LOGI(TAG, "LVGL pool: %u bytes in %s", (unsigned)size, poolInPsram ? "PSRAM" : "internal RAM");
+    return pool;
+}
+
+void *displayMemDmaAlloc(size_t size)
+{
+    void *ptr = heap_caps_malloc(size, MEM_CAPS_DMA);
+    _track(ptr, size, &dmaUsage);
+    return ptr;
+}
+
+void *displayMemAlloc(size_t size)
+{
+    // Without PSRAM this ends up in the same internal RAM as the DMA buffers
+    void *ptr = heap_caps_malloc_prefer(size, 2, MEM_CAPS_PSRAM, MEM_CAPS_INTERNAL);
+    _track(ptr, size, &bulkUsage);
+    return ptr;
+}
+
+void displayMemFree(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    portENTER_CRITICAL(&memLock);
+    for (int i = 0; i < MEM_MAX_BUFFERS; i++) {
+        if (buffers[i].ptr == ptr) {
+            buffers[i].usage->used -= buffers[i].size;
+            buffers[i].usage->count--;
+            buffers[i].ptr = NULL;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&memLock);
+
+    heap_caps_free(ptr);
+}
+
+void displayMemGetReport(displayMemReport_t *report)
+{
+    memset(report, 0, sizeof(*report));
+
+    portENTER_CRITICAL(&memLock);
+    report->dma = dmaUsage;
+    report->bulk = bulkUsage;
+    portEXIT_CRITICAL(&memLock);
+
+    report->poolInPsram = poolInPsram;
+    report->poolSize = poolSize;
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    report->poolUsed = mon.total_size - mon.free_size;
+    report->poolMaxUsed = mon.max_used;
+    report->poolFragPct = mon.frag_pct;
+    report->poolFreeBiggest = mon.free_biggest_size;
+
+    report->dmaFree = heap_caps_get_free_size(MEM_CAPS_DMA);
+    report->dmaLargest = heap_caps_get_largest_free_block(MEM_CAPS_DMA);
+}
+
+void displayMemProcess(void)
+{
+    int64_t now = esp_timer_get_time();
+    if (now - lastLogUs < MEM_LOG_PERIOD_US) {
+        return;
+    }
+    lastLogUs = now;
+
+    displayMemReport_t r;
+    displayMemGetReport(&r);
+
+    ESP_LOGI(TAG, "pool_psram=%d pool_size=%lu pool_used=%lu pool_max_used=%lu pool_frag_pct=%lu pool_free_biggest=%lu "
+             "dma_used=%lu dma_peak=%lu dma_buffers=%lu dma_failed=%lu "
+             "bulk_used=%lu bulk_peak=%lu bulk_buffers=%lu bulk_failed=%lu "
+             "dma_heap_free=%lu dma_heap_largest=%lu",
+             r.poolInPsram, (unsigned long)r.poolSize, (unsigned long)r.poolUsed,
+             (unsigned long)r.poolMaxUsed, (unsigned long)r.poolFragPct, (unsigned long)r.poolFreeBiggest,
+             (unsigned long)r.dma.used, (unsigned long)r.dma.peak,
+             (unsigned long)r.dma.count, (unsigned long)r.dma.failed,
+             (unsigned long)r.bulk.used, (unsigned long)r.bulk.peak,
+             (unsigned long)r.bulk.count, (unsigned long)r.bulk.failed,
+             (unsigned long)r.dmaFree, (unsigned long)r.dmaLargest);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _track(void *ptr, size_t size, displayMemUsage_t *usage)
+{
+    bool tracked = false;
+
+    portENTER_CRITICAL(&memLock);
+    if (!ptr) {
+        usage->failed++;
+    } else {
+        for (int i = 0; i < MEM_MAX_BUFFERS; i++) {
+            if (!buffers[i].ptr) {
+                buffers[i].ptr = ptr;
+                buffers[i].size = size;
+                buffers[i].usage = usage;
+                tracked = true;
+                break;
+            }
+        }
+        if (tracked) {
+            usage->used += size;
+            usage->count++;
+            if (usage->used > usage->peak) {
+                usage->peak = usage->used;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&memLock);
+
+    if (!ptr) {
+        ESP_LOGE(TAG, "Allocation of %u bytes failed, largest DMA block %u", (unsigned)size,
+                 (unsigned)heap_caps_get_largest_free_block(MEM_CAPS_DMA));
+    } else if (!tracked) {
+        ESP_LOGW(TAG, "More than %d buffers, %u bytes not accounted", MEM_MAX_BUFFERS, (unsigned)size);
+    }
+}
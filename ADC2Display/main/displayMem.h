@@ -0,0 +1,100 @@
+/// \file		displayMem.h
+///
+/// \brief	Memory of the display stack: LVGL pool, DMA and bulk buffers
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_MEM_H
+#define DISPLAY_MEM_H
+
+// Also included by LVGL's lv_mem.c (LV_MEM_POOL_INCLUDE), keep it free of
+// LVGL and IDF headers
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t used;                  // Bytes currently allocated
+    uint32_t peak;
+    uint32_t count;                 // Buffers currently allocated
+    uint32_t failed;                // Allocations that returned NULL
+} displayMemUsage_t;
+
+typedef struct {
+    bool poolInPsram;
+    uint32_t poolSize;
+    uint32_t poolUsed;              // From lv_mem_monitor()
+    uint32_t poolMaxUsed;
+    uint32_t poolFragPct;
+    uint32_t poolFreeBiggest;
+    displayMemUsage_t dma;          // Flush buffers, internal DMA capable RAM
+    displayMemUsage_t bulk;         // Other large buffers, PSRAM first
+    uint32_t dmaFree;               // Internal DMA capable heap left
+    uint32_t dmaLargest;
+} displayMemReport_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Memory handed to the LVGL TLSF allocator, called from lv_init()
+ *
+ * Taken from PSRAM when the board has some, so the widgets never compete
+ * with the flush buffers for internal RAM.
+ */
+void *displayMemPoolAlloc(size_t size);
+
+/**
+ * @brief Buffer the SPI DMA reads from: draw, staging and blit buffers
+ */
+void *displayMemDmaAlloc(size_t size);
+
+/**
+ * @brief Large buffer only touched by the CPU, placed in PSRAM if possible
+ */
+void *displayMemAlloc(size_t size);
+
+/**
+ * @brief Free a buffer from displayMemDmaAlloc() or displayMemAlloc()
+ */
+void displayMemFree(void *ptr);
+
+void displayMemGetReport(displayMemReport_t *report);
+
+/**
+ * @brief Log the report every few seconds, from the task owning LVGL
+ */
+void displayMemProcess(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_MEM_H
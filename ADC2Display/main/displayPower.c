@@ -0,0 +1,255 @@
+/// \file		displayPower.c
+///
+/// \brief	Display power states driven by UI activity and buttons
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "tft_driver.h"
+#include "backlight.h"
+#include "displayServer.h"
+#include "displayPower.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+static void _enter(displayPowerState_t state, int64_t now);
+
+/**
+ * @brief Add the time since the last call to the current state
+ */
+static void _account(int64_t now);
+
+static void _buttonIsr(void *arg);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayPower";
+
+static const char *const stateNames[DISPLAY_POWER_STATES] = { "active", "dimmed", "sleep", "off" };
+
+static displayPowerConfig_t pwConfig;
+static displayPowerState_t pwState = DISPLAY_POWER_ACTIVE;
+static int64_t lastActivityUs = 0;
+
+// Set from the button ISR or other tasks, picked up by displayPowerProcess().
+// The stamp is the low half of esp_timer_get_time(), enough for a latency.
+static volatile bool activityPending = false;
+static volatile uint32_t activityStampUs = 0;
+
+// The panel goes to sleep once the backlight fade is over
+static bool panelAsleep = false;
+static int64_t panelSleepAtUs = 0;
+
+static uint64_t stateUs[DISPLAY_POWER_STATES];
+static uint32_t stateEntries[DISPLAY_POWER_STATES];
+static int64_t accountedUs = 0;
+static uint32_t lastWakeUs = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+esp_err_t displayPowerInit(const displayPowerConfig_t *config)
+{
+    pwConfig = *config;
+    pwState = DISPLAY_POWER_ACTIVE;
+    lastActivityUs = accountedUs = esp_timer_get_time();
+    memset(stateUs, 0, sizeof(stateUs));
+    memset(stateEntries, 0, sizeof(stateEntries));
+    stateEntries[DISPLAY_POWER_ACTIVE] = 1;
+
+    // Another driver may have installed the service already
+    esp_err_t ret = gpio_install_isr_service(0);
+    ESP_RETURN_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE, ret, TAG, "isr service failed");
+
+    for (int i = 0; i < DISPLAY_POWER_MAX_BUTTONS; i++) {
+        const int pin = pwConfig.buttons[i];
+        if (pin < 0) {
+            continue;
+        }
+        // Input only pins have no pull-up, the board has external ones there
+        const gpio_config_t io_conf = {
+            .pin_bit_mask = 1ULL << pin,
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = GPIO_IS_VALID_OUTPUT_GPIO(pin) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+            .intr_type = GPIO_INTR_NEGEDGE,
+        };
+        ESP_RETURN_ON_ERROR(gpio_config(&io_conf), TAG, "button %d config failed", pin);
+        ESP_RETURN_ON_ERROR(gpio_isr_handler_add(pin, _buttonIsr, NULL), TAG, "button %d isr failed", pin);
+    }
+
+    return ESP_OK;
+}
+
+void displayPowerActivity(void)
+{
+    activityStampUs = (uint32_t)esp_timer_get_time();
+    activityPending = true;
+    displayServerWake();
+}
+
+void displayPowerProcess(void)
+{
+    const int64_t now = esp_timer_get_time();
+
+    bool woken = false;
+    if (activityPending) {
+        activityPending = false;
+        lastActivityUs = now;
+        woken = pwState >= DISPLAY_POWER_SLEEP;
+    }
+    if (!displayServerIsPaused()) {
+        // Input devices registered with LVGL keep the display awake too
+        const int64_t lvglActivityUs = now - (int64_t)lv_disp_get_inactive_time(NULL) * 1000;
+        if (lvglActivityUs > lastActivityUs) {
+            lastActivityUs = lvglActivityUs;
+        }
+    }
+
+    const uint32_t inactiveMs = (uint32_t)((now - lastActivityUs) / 1000);
+    displayPowerState_t target = DISPLAY_POWER_ACTIVE;
+    if (pwConfig.offTimeoutMs && inactiveMs >= pwConfig.offTimeoutMs) {
+        target = DISPLAY_POWER_OFF;
+    } else if (pwConfig.sleepTimeoutMs && inactiveMs >= pwConfig.sleepTimeoutMs) {
+        target = DISPLAY_POWER_SLEEP;
+    } else if (pwConfig.dimTimeoutMs && inactiveMs >= pwConfig.dimTimeoutMs) {
+        target = DISPLAY_POWER_DIMMED;
+    }
+    if (target != pwState) {
+        _enter(target, now);
+        if (woken) {
+            lastWakeUs = (uint32_t)esp_timer_get_time() - activityStampUs;
+            ESP_LOGI(TAG, "wake_us=%lu", (unsigned long)lastWakeUs);
+        }
+    }
+
+    if (panelSleepAtUs && now >= panelSleepAtUs) {
+        panelSleepAtUs = 0;
+        panelAsleep = display_set_panel_power(false) == ESP_OK;
+    }
+
+    backlightProcess();
+}
+
+displayPowerState_t displayPowerGetState(void)
+{
+    return pwState;
+}
+
+void displayPowerGetReport(displayPowerReport_t *report)
+{
+    _account(esp_timer_get_time());
+    for (int i = 0; i < DISPLAY_POWER_STATES; i++) {
+        report->timeMs[i] = stateUs[i] / 1000;
+        report->entries[i] = stateEntries[i];
+    }
+    report->state = pwState;
+    report->lastWakeUs = lastWakeUs;
+    report->backlightDutyPermille = backlightGetAverageDuty();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _enter(displayPowerState_t state, int64_t now)
+{
+    const displayPowerState_t from = pwState;
+    _account(now);
+
+    if (state < DISPLAY_POWER_SLEEP) {
+        // The panel RAM still holds the last frame, only light it again
+        panelSleepAtUs = 0;
+        if (panelAsleep) {
+            panelAsleep = display_set_panel_power(true) != ESP_OK;
+        }
+        if (from == DISPLAY_POWER_OFF) {
+            displayServerSetPaused(false);
+            if (pwConfig.onPause) {
+                pwConfig.onPause(false);
+            }
+            lv_disp_trig_activity(NULL);
+        }
+        backlightSetState(state == DISPLAY_POWER_ACTIVE ? BACKLIGHT_ACTIVE : BACKLIGHT_DIMMED);
+    } else {
+        const uint32_t fadeMs = backlightSetState(BACKLIGHT_OFF);
+        if (!panelAsleep && !panelSleepAtUs) {
+            panelSleepAtUs = now + (int64_t)fadeMs * 1000 + 1;
+        }
+        if (state == DISPLAY_POWER_OFF) {
+            if (pwConfig.onPause) {
+                pwConfig.onPause(true);
+            }
+            displayServerSetPaused(true);
+        } else if (from == DISPLAY_POWER_OFF) {
+            displayServerSetPaused(false);
+            if (pwConfig.onPause) {
+                pwConfig.onPause(false);
+            }
+        }
+    }
+
+    pwState = state;
+    stateEntries[state]++;
+
+    ESP_LOGI(TAG, "state=%s active_ms=%llu dimmed_ms=%llu sleep_ms=%llu off_ms=%llu bl_duty_permille=%lu",
+             stateNames[state],
+             (unsigned long long)(stateUs[DISPLAY_POWER_ACTIVE] / 1000),
+             (unsigned long long)(stateUs[DISPLAY_POWER_DIMMED] / 1000),
+             (unsigned long long)(stateUs[DISPLAY_POWER_SLEEP] / 1000),
+             (unsigned long long)(stateUs[DISPLAY_POWER_OFF] / 1000),
+             (unsigned long)backlightGetAverageDuty());
+}
+
+void _account(int64_t now)
+{
+    stateUs[pwState] += (uint64_t)(now - accountedUs);
+    accountedUs = now;
+}
+
+void _buttonIsr(void *arg)
+{
+    activityStampUs = (uint32_t)esp_timer_get_time();
+    activityPending = true;
+    displayServerWakeFromISR();
+}
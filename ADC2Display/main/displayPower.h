@@ -0,0 +1,109 @@
+/// \file		displayPower.h
+///
+/// \brief	Display power states driven by UI activity and buttons
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_POWER_H
+#define DISPLAY_POWER_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#define DISPLAY_POWER_MAX_BUTTONS   2
+
+/**
+ * The panel keeps its frame memory while asleep, so waking up from sleep or
+ * off only lights it again. Nothing is redrawn but what changed meanwhile.
+ */
+typedef enum {
+    DISPLAY_POWER_ACTIVE,
+    DISPLAY_POWER_DIMMED,
+    DISPLAY_POWER_SLEEP,            // Backlight off, panel asleep, LVGL still renders
+    DISPLAY_POWER_OFF,              // As sleep, with LVGL and its tick stopped
+    DISPLAY_POWER_STATES,
+} displayPowerState_t;
+
+/**
+ * Timeouts count from the last activity, 0 disables the step. Buttons are
+ * active low GPIOs, -1 for none; any press counts as activity.
+ */
+typedef struct {
+    uint32_t dimTimeoutMs;
+    uint32_t sleepTimeoutMs;
+    uint32_t offTimeoutMs;
+    int buttons[DISPLAY_POWER_MAX_BUTTONS];
+    void (*onPause)(bool paused);   // Entering or leaving off, from the server task
+} displayPowerConfig_t;
+
+typedef struct {
+    uint64_t timeMs[DISPLAY_POWER_STATES];  // Time spent in each state since init
+    uint32_t entries[DISPLAY_POWER_STATES];
+    displayPowerState_t state;
+    uint32_t lastWakeUs;            // From the input to the backlight turning on
+    uint32_t backlightDutyPermille; // Average since boot
+} displayPowerReport_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Start in the active state and arm the button interrupts
+ *
+ * The backlight must already be initialized.
+ */
+esp_err_t displayPowerInit(const displayPowerConfig_t *config);
+
+/**
+ * @brief Restart the inactivity timers, from any task
+ */
+void displayPowerActivity(void);
+
+/**
+ * @brief Run the state machine
+ *
+ * Call from the display server onUpdate callback, which keeps running while
+ * rendering is paused. LVGL input activity counts as well.
+ */
+void displayPowerProcess(void);
+
+displayPowerState_t displayPowerGetState(void);
+
+/**
+ * @brief Time per state so far, from the server task
+ */
+void displayPowerGetReport(displayPowerReport_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_POWER_H
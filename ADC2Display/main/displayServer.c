@@ -0,0 +1,392 @@
+/// \file		displayServer.c
+///
+/// \brief	Task owning LVGL, fed by a queue of typed update messages
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "displayStats.h"
+#include "displayServer.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define SERVER_QUEUE_LEN            64
+#define SERVER_MSG_SAMPLES          (DISPLAY_SERVER_TEXT_LEN / sizeof(int16_t))
+#define SERVER_PENDING_SAMPLES      64
+#define SERVER_TASK_STACK_SIZE      (4 * 1024)
+#define SERVER_TASK_MAX_DELAY_MS    500
+#define SERVER_TASK_MIN_DELAY_MS    1
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+    _MSG_SET_VALUE,
+    _MSG_SET_TEXT,
+    _MSG_PUSH_SAMPLES,
+    _MSG_CALL,
+} _msgType_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t id;
+    uint8_t count;
+    union {
+        int32_t value;
+        char text[DISPLAY_SERVER_TEXT_LEN];
+        int16_t samples[SERVER_MSG_SAMPLES];
+        struct {
+            void (*fn)(void *arg);
+            void *arg;
+        } call;
+    };
+} _msg_t;
+
+// Updates received for one target during the current frame
+typedef struct {
+    bool used;
+    displayServerTarget_t target;
+    lv_obj_t *obj;                  // Built-in label and chart targets
+    lv_chart_series_t *series;
+    bool hasValue;
+    int32_t value;
+    bool hasText;
+    char text[DISPLAY_SERVER_TEXT_LEN];
+    int16_t samples[SERVER_PENDING_SAMPLES];
+    size_t sampleCount;
+} _slot_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief The only task calling LVGL
+ */
+static void _serverTask(void *arg);
+
+/**
+ * @brief Take every queued message and merge it into the slots
+ */
+static void _drain(void);
+
+/**
+ * @brief Hand the merged updates to the targets
+ */
+static void _apply(void);
+
+static void _flushSamples(_slot_t *slot);
+static bool _post(const _msg_t *msg);
+
+static void _labelSetValue(void *ctx, int32_t value);
+static void _labelSetText(void *ctx, const char *text);
+static void _chartPushSamples(void *ctx, const int16_t *samples, size_t count);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayServer";
+
+static QueueHandle_t queue = NULL;
+static TaskHandle_t serverTask = NULL;
+static volatile bool paused = false;
+static displayServerConfig_t serverConfig;
+static _slot_t slots[DISPLAY_SERVER_MAX_TARGETS];
+
+// Only a statistic, increments from concurrent producers may be lost
+static volatile uint32_t dropped = 0;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void displayServerStart(const displayServerConfig_t *config)
+{
+    serverConfig = *config;
+
+    queue = xQueueCreate(SERVER_QUEUE_LEN, sizeof(_msg_t));
+    assert(queue);
+
+    ESP_LOGI(TAG, "Create LVGL task");
+    xTaskCreate(_serverTask, "LVGL", SERVER_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, &serverTask);
+}
+
+bool displayServerRegister(uint8_t id, const displayServerTarget_t *target)
+{
+    if (id >= DISPLAY_SERVER_MAX_TARGETS) {
+        ESP_LOGE(TAG, "Target %u out of range", id);
+        return false;
+    }
+    memset(&slots[id], 0, sizeof(_slot_t));
+    slots[id].target = *target;
+    slots[id].used = true;
+    return true;
+}
+
+bool displayServerRegisterLabel(uint8_t id, lv_obj_t *label)
+{
+    if (id >= DISPLAY_SERVER_MAX_TARGETS) {
+        return false;
+    }
+    const displayServerTarget_t target = {
+        .setValue = _labelSetValue,
+        .setText = _labelSetText,
+        .ctx = &slots[id],
+    };
+    if (!displayServerRegister(id, &target)) {
+        return false;
+    }
+    slots[id].obj = label;
+    return true;
+}
+
+bool displayServerRegisterChart(uint8_t id, lv_obj_t *chart, lv_chart_series_t *series)
+{
+    if (id >= DISPLAY_SERVER_MAX_TARGETS) {
+        return false;
+    }
+    const displayServerTarget_t target = {
+        .pushSamples = _chartPushSamples,
+        .ctx = &slots[id],
+    };
+    if (!displayServerRegister(id, &target)) {
+        return false;
+    }
+    slots[id].obj = chart;
+    slots[id].series = series;
+    return true;
+}
+
+bool displayServerSetValue(uint8_t id, int32_t value)
+{
+    _msg_t msg = { .type = _MSG_SET_VALUE, .id = id, .value = value };
+    return _post(&msg);
+}
+
+bool displayServerSetText(uint8_t id, const char *text)
+{
+    _msg_t msg = { .type = _MSG_SET_TEXT, .id = id };
+    strncpy(msg.text, text, sizeof(msg.text) - 1);
+    return _post(&msg);
+}
+
+bool displayServerPushSamples(uint8_t id, const int16_t *samples, size_t count)
+{
+    bool ok = true;
+    while (count) {
+        _msg_t msg = { .type = _MSG_PUSH_SAMPLES, .id = id };
+        msg.count = count < SERVER_MSG_SAMPLES ? count : SERVER_MSG_SAMPLES;
+        memcpy(msg.samples, samples, msg.count * sizeof(int16_t));
+        ok &= _post(&msg);
+        samples += msg.count;
+        count -= msg.count;
+    }
+    return ok;
+}
+
+bool displayServerCall(void (*fn)(void *arg), void *arg)
+{
+    _msg_t msg = { .type = _MSG_CALL, .call = { fn, arg } };
+    return _post(&msg);
+}
+
+void displayServerSetPaused(bool pause)
+{
+    paused = pause;
+    displayServerWake();
+}
+
+bool displayServerIsPaused(void)
+{
+    return paused;
+}
+
+void displayServerWake(void)
+{
+    if (serverTask) {
+        xTaskNotifyGive(serverTask);
+    }
+}
+
+void displayServerWakeFromISR(void)
+{
+    BaseType_t needYield = pdFALSE;
+    if (serverTask) {
+        vTaskNotifyGiveFromISR(serverTask, &needYield);
+    }
+    portYIELD_FROM_ISR(needYield);
+}
+
+uint32_t displayServerGetDropped(void)
+{
+    return dropped;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _serverTask(void *arg)
+{
+    ESP_LOGI(TAG, "Starting LVGL task");
+    if (serverConfig.onStart) {
+        serverConfig.onStart();
+    }
+
+    uint32_t taskDelayMs = SERVER_TASK_MAX_DELAY_MS;
+    while (1) {
+        _drain();
+        _apply();
+        if (serverConfig.onUpdate) {
+            serverConfig.onUpdate();
+        }
+
+        if (paused) {
+            // Nothing is rendered, only posted updates are taken in
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SERVER_TASK_MAX_DELAY_MS));
+            continue;
+        }
+
+        displayStatsRenderBegin();
+        taskDelayMs = lv_timer_handler();   // Process LVGL tasks
+        displayStatsRenderEnd();
+
+        if (serverConfig.onFrame) {
+            serverConfig.onFrame();
+        }
+        displayStatsProcess();
+
+        if (taskDelayMs > SERVER_TASK_MAX_DELAY_MS) {
+            taskDelayMs = SERVER_TASK_MAX_DELAY_MS;
+        } else if (taskDelayMs < SERVER_TASK_MIN_DELAY_MS) {
+            taskDelayMs = SERVER_TASK_MIN_DELAY_MS;
+        }
+        // A wake request cuts the wait short
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(taskDelayMs));
+    }
+}
+
+void _drain(void)
+{
+    _msg_t msg;
+    while (xQueueReceive(queue, &msg, 0) == pdTRUE) {
+        if (msg.type == _MSG_CALL) {
+            // Calls see every update posted before them
+            _apply();
+            msg.call.fn(msg.call.arg);
+            continue;
+        }
+
+        if (msg.id >= DISPLAY_SERVER_MAX_TARGETS || !slots[msg.id].used) {
+            continue;
+        }
+        _slot_t *slot = &slots[msg.id];
+
+        switch (msg.type) {
+        case _MSG_SET_VALUE:
+            slot->value = msg.value;
+            slot->hasValue = true;
+            break;
+        case _MSG_SET_TEXT:
+            memcpy(slot->text, msg.text, sizeof(slot->text));
+            slot->hasText = true;
+            break;
+        case _MSG_PUSH_SAMPLES:
+            if (slot->sampleCount + msg.count > SERVER_PENDING_SAMPLES) {
+                _flushSamples(slot);
+            }
+            memcpy(&slot->samples[slot->sampleCount], msg.samples, msg.count * sizeof(int16_t));
+            slot->sampleCount += msg.count;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void _apply(void)
+{
+    for (int i = 0; i < DISPLAY_SERVER_MAX_TARGETS; i++) {
+        _slot_t *slot = &slots[i];
+        if (!slot->used) {
+            continue;
+        }
+        if (slot->hasValue && slot->target.setValue) {
+            slot->target.setValue(slot->target.ctx, slot->value);
+        }
+        if (slot->hasText && slot->target.setText) {
+            slot->target.setText(slot->target.ctx, slot->text);
+        }
+        slot->hasValue = false;
+        slot->hasText = false;
+        _flushSamples(slot);
+    }
+}
+
+void _flushSamples(_slot_t *slot)
+{
+    if (slot->sampleCount && slot->target.pushSamples) {
+        slot->target.pushSamples(slot->target.ctx, slot->samples, slot->sampleCount);
+    }
+    slot->sampleCount = 0;
+}
+
+bool _post(const _msg_t *msg)
+{
+    if (!queue || xQueueSend(queue, msg, 0) != pdTRUE) {
+        dropped++;
+        return false;
+    }
+    return true;
+}
+
+void _labelSetValue(void *ctx, int32_t value)
+{
+    lv_label_set_text_fmt(((_slot_t *)ctx)->obj, "%ld", (long)value);
+}
+
+void _labelSetText(void *ctx, const char *text)
+{
+    lv_label_set_text(((_slot_t *)ctx)->obj, text);
+}
+
+void _chartPushSamples(void *ctx, const int16_t *samples, size_t count)
+{
+#if LV_USE_CHART
+    _slot_t *slot = (_slot_t *)ctx;
+    for (size_t i = 0; i < count; i++) {
+        lv_chart_set_next_value(slot->obj, slot->series, samples[i]);
+    }
+#endif
+}
@@ -0,0 +1,128 @@
+/// \file		displayServer.h
+///
+/// \brief	Task owning LVGL, fed by a queue of typed update messages
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_SERVER_H
+#define DISPLAY_SERVER_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#define DISPLAY_SERVER_MAX_TARGETS  16
+#define DISPLAY_SERVER_TEXT_LEN     24
+
+/**
+ * @brief What a target does with the updates posted to it
+ *
+ * Handlers run in the server task and may use any LVGL API. Unused ones can
+ * be left NULL.
+ */
+typedef struct {
+    void (*setValue)(void *ctx, int32_t value);
+    void (*setText)(void *ctx, const char *text);
+    void (*pushSamples)(void *ctx, const int16_t *samples, size_t count);
+    void *ctx;
+} displayServerTarget_t;
+
+typedef struct {
+    void (*onStart)(void);          // Build the UI, first thing in the server task
+    void (*onUpdate)(void);         // Before every lv_timer_handler(), after the queue
+    void (*onFrame)(void);          // After every lv_timer_handler()
+} displayServerConfig_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Create the queue and the task that owns LVGL from now on
+ *
+ * LVGL and the display driver must already be initialized.
+ */
+void displayServerStart(const displayServerConfig_t *config);
+
+/**
+ * @brief Register a target, from onStart or another server task callback
+ */
+bool displayServerRegister(uint8_t id, const displayServerTarget_t *target);
+
+/**
+ * @brief Register a label, values are shown with "%ld"
+ */
+bool displayServerRegisterLabel(uint8_t id, lv_obj_t *label);
+
+/**
+ * @brief Register a chart series, samples are appended with lv_chart_set_next_value()
+ */
+bool displayServerRegisterChart(uint8_t id, lv_obj_t *chart, lv_chart_series_t *series);
+
+/**
+ * Posting never blocks. Values and texts posted to the same target within one
+ * frame are coalesced, only the last one is applied. Samples are applied in
+ * order. A false return means the queue was full and the update was dropped.
+ */
+bool displayServerSetValue(uint8_t id, int32_t value);
+bool displayServerSetText(uint8_t id, const char *text);
+bool displayServerPushSamples(uint8_t id, const int16_t *samples, size_t count);
+
+/**
+ * @brief Run \p fn in the server task, in order with the other messages
+ */
+bool displayServerCall(void (*fn)(void *arg), void *arg);
+
+/**
+ * @brief Stop or resume rendering
+ *
+ * While paused lv_timer_handler() and onFrame are not called, so LVGL timers
+ * and the panel stay idle. onUpdate still runs, every
+ * SERVER_TASK_MAX_DELAY_MS or when woken, and posted updates are applied to
+ * the objects, to be drawn on resume.
+ */
+void displayServerSetPaused(bool pause);
+bool displayServerIsPaused(void);
+
+/**
+ * @brief Run the server loop now instead of at the end of its current wait
+ */
+void displayServerWake(void);
+void displayServerWakeFromISR(void);
+
+/**
+ * @brief Updates dropped because the queue was full
+ */
+uint32_t displayServerGetDropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_SERVER_H
@@ -0,0 +1,423 @@
+/// \file		displayStats.c
+///
+/// \brief	Frame timing and LVGL memory instrumentation
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include "displayStats.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define STATS_WINDOW                64      // Samples kept for the rolling numbers
+#define STATS_PENDING               8       // Flushes that can be in flight
+#define STATS_PERIOD_US             (1000 * 1000)
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t samples[STATS_WINDOW];
+    uint32_t count;
+    uint32_t next;
+} _window_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t sum;
+    uint32_t max;
+} _total_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+static void _windowAdd(_window_t *window, uint32_t value);
+static void _totalAdd(_total_t *total, uint32_t value);
+
+/**
+ * @brief Average and percentiles of a copy of the window
+ */
+static void _windowSummary(const _window_t *window, displayStatsSummary_t *summary);
+
+/**
+ * @brief Window percentiles, average and max over every sample of the segment
+ */
+static void _segmentSummary(const _window_t *window, const _total_t *total, displayStatsSummary_t *summary);
+
+/**
+ * @brief Bytes of the LVGL pool in use right now
+ */
+static uint32_t _memUsed(void);
+
+static void _createOverlay(void);
+static void _updateOverlay(void);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "displayStats";
+
+// Flush completions come from the SPI ISR, possibly on the other core
+static portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+
+static _window_t renderWindow;
+static _window_t flushWindow;
+
+static int64_t renderStart;
+static int64_t pendingStart[STATS_PENDING];
+static uint32_t pendingHead;
+static uint32_t pendingTail;
+
+static uint32_t frames;
+static uint32_t dmaDone;
+static int64_t periodStart;
+
+// Segment, see displayStatsSegmentBegin()
+static uint32_t segFrames;
+static uint32_t segDmaDone;
+static int64_t segStart;
+static bool segActive = false;
+static _total_t segRender;
+static _total_t segFlush;
+static uint32_t segMemBase;         // lv_mem_monitor() max_used at the start
+static uint32_t segMemPeak;         // Largest pool use seen after a frame
+
+static bool enabled = false;
+static displayStatsReport_t report;
+static lv_obj_t *overlay = NULL;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void displayStatsInit(bool showOverlay)
+{
+    portENTER_CRITICAL(&statsLock);
+    memset(&renderWindow, 0, sizeof(renderWindow));
+    memset(&flushWindow, 0, sizeof(flushWindow));
+    pendingHead = pendingTail = 0;
+    frames = dmaDone = 0;
+    portEXIT_CRITICAL(&statsLock);
+
+    memset(&report, 0, sizeof(report));
+    periodStart = esp_timer_get_time();
+    enabled = true;
+
+    if (showOverlay) {
+        _createOverlay();
+    }
+}
+
+void displayStatsRenderBegin(void)
+{
+    if (!enabled) {
+        return;
+    }
+    renderStart = esp_timer_get_time();
+}
+
+void displayStatsRenderEnd(void)
+{
+    if (!enabled) {
+        return;
+    }
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - renderStart);
+    _windowAdd(&renderWindow, elapsed);
+    _totalAdd(&segRender, elapsed);
+
+    // Sampled outside the timed part, lv_mem_monitor() walks the whole pool
+    if (segActive) {
+        uint32_t used = _memUsed();
+        if (used > segMemPeak) {
+            segMemPeak = used;
+        }
+    }
+}
+
+void displayStatsFlushBegin(bool last)
+{
+    if (!enabled) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&statsLock);
+    if (pendingHead - pendingTail < STATS_PENDING) {
+        pendingStart[pendingHead++ % STATS_PENDING] = now;
+    }
+    if (last) {
+        frames++;
+        segFrames++;
+    }
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void IRAM_ATTR displayStatsFlushDone(void)
+{
+    if (!enabled) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&statsLock);
+    if (pendingTail != pendingHead) {
+        int64_t start = pendingStart[pendingTail++ % STATS_PENDING];
+        uint32_t elapsed = (uint32_t)(now - start);
+        flushWindow.samples[flushWindow.next] = elapsed;
+        flushWindow.next = (flushWindow.next + 1) % STATS_WINDOW;
+        if (flushWindow.count < STATS_WINDOW) {
+            flushWindow.count++;
+        }
+        segFlush.count++;
+        segFlush.sum += elapsed;
+        if (elapsed > segFlush.max) {
+            segFlush.max = elapsed;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&statsLock);
+}
+
+void IRAM_ATTR displayStatsDmaDone(void)
+{
+    portENTER_CRITICAL_ISR(&statsLock);
+    dmaDone++;
+    segDmaDone++;
+    portEXIT_CRITICAL_ISR(&statsLock);
+}
+
+void displayStatsProcess(void)
+{
+    if (!enabled) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    if (now - periodStart < STATS_PERIOD_US) {
+        return;
+    }
+
+    _window_t flushCopy;
+    uint32_t frameCount, dmaCount;
+
+    portENTER_CRITICAL(&statsLock);
+    flushCopy = flushWindow;
+    frameCount = frames;
+    dmaCount = dmaDone;
+    frames = dmaDone = 0;
+    portEXIT_CRITICAL(&statsLock);
+
+    uint32_t elapsedMs = (uint32_t)((now - periodStart) / 1000);
+    periodStart = now;
+
+    report.fps = frameCount * 1000 / elapsedMs;
+    report.dmaPerSec = dmaCount * 1000 / elapsedMs;
+    _windowSummary(&renderWindow, &report.renderUs);
+    _windowSummary(&flushCopy, &report.flushUs);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    report.memUsedPct = mon.used_pct;
+    report.memFragPct = mon.frag_pct;
+    report.memMaxUsed = mon.max_used;
+    report.memFreeBiggest = mon.free_biggest_size;
+
+    // One key=value line per period so logs can be grepped and plotted
+    ESP_LOGI(TAG, "fps=%lu dma_per_s=%lu render_avg_us=%lu render_p50_us=%lu render_p95_us=%lu render_max_us=%lu "
+             "flush_avg_us=%lu flush_p50_us=%lu flush_p95_us=%lu flush_max_us=%lu "
+             "mem_used_pct=%lu mem_frag_pct=%lu mem_max_used=%lu mem_free_biggest=%lu",
+             (unsigned long)report.fps, (unsigned long)report.dmaPerSec,
+             (unsigned long)report.renderUs.avg, (unsigned long)report.renderUs.p50,
+             (unsigned long)report.renderUs.p95, (unsigned long)report.renderUs.max,
+             (unsigned long)report.flushUs.avg, (unsigned long)report.flushUs.p50,
+             (unsigned long)report.flushUs.p95, (unsigned long)report.flushUs.max,
+             (unsigned long)report.memUsedPct, (unsigned long)report.memFragPct,
+             (unsigned long)report.memMaxUsed, (unsigned long)report.memFreeBiggest);
+
+    if (overlay) {
+        _updateOverlay();
+    }
+}
+
+void displayStatsGetReport(displayStatsReport_t *out)
+{
+    *out = report;
+}
+
+void displayStatsSegmentBegin(void)
+{
+    // The windows only hold samples of this segment from here on
+    portENTER_CRITICAL(&statsLock);
+    memset(&renderWindow, 0, sizeof(renderWindow));
+    memset(&flushWindow, 0, sizeof(flushWindow));
+    memset(&segRender, 0, sizeof(segRender));
+    memset(&segFlush, 0, sizeof(segFlush));
+    segFrames = segDmaDone = 0;
+    portEXIT_CRITICAL(&statsLock);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    segMemBase = mon.max_used;
+    segMemPeak = mon.total_size - mon.free_size;
+    segActive = true;
+
+    segStart = esp_timer_get_time();
+}
+
+void displayStatsSegmentEnd(displayStatsReport_t *out)
+{
+    _window_t flushCopy;
+    _total_t flushTotal;
+    uint32_t frameCount, dmaCount;
+
+    portENTER_CRITICAL(&statsLock);
+    flushCopy = flushWindow;
+    flushTotal = segFlush;
+    frameCount = segFrames;
+    dmaCount = segDmaDone;
+    portEXIT_CRITICAL(&statsLock);
+
+    segActive = false;
+    uint32_t elapsedMs = (uint32_t)((esp_timer_get_time() - segStart) / 1000);
+    if (elapsedMs == 0) {
+        elapsedMs = 1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->fps = frameCount * 1000 / elapsedMs;
+    out->dmaPerSec = dmaCount * 1000 / elapsedMs;
+    _segmentSummary(&renderWindow, &segRender, &out->renderUs);
+    _segmentSummary(&flushCopy, &flushTotal, &out->flushUs);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    out->memUsedPct = mon.used_pct;
+    out->memFragPct = mon.frag_pct;
+    out->memFreeBiggest = mon.free_biggest_size;
+
+    // max_used counts since boot, so it is the segment peak only if the
+    // segment raised it; otherwise use the per-frame samples
+    uint32_t used = mon.total_size - mon.free_size;
+    if (mon.max_used > segMemBase) {
+        out->memMaxUsed = mon.max_used;
+    } else {
+        out->memMaxUsed = used > segMemPeak ? used : segMemPeak;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _windowAdd(_window_t *window, uint32_t value)
+{
+    window->samples[window->next] = value;
+    window->next = (window->next + 1) % STATS_WINDOW;
+    if (window->count < STATS_WINDOW) {
+        window->count++;
+    }
+}
+
+void _totalAdd(_total_t *total, uint32_t value)
+{
+    total->count++;
+    total->sum += value;
+    if (value > total->max) {
+        total->max = value;
+    }
+}
+
+void _windowSummary(const _window_t *window, displayStatsSummary_t *summary)
+{
+    uint32_t sorted[STATS_WINDOW];
+    uint32_t count = window->count;
+    uint64_t sum = 0;
+
+    memset(summary, 0, sizeof(*summary));
+    if (count == 0) {
+        return;
+    }
+
+    // Insertion sort, the window is small
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t value = window->samples[i];
+        uint32_t j = i;
+        sum += value;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    summary->avg = (uint32_t)(sum / count);
+    summary->p50 = sorted[(count - 1) * 50 / 100];
+    summary->p95 = sorted[(count - 1) * 95 / 100];
+    summary->max = sorted[count - 1];
+}
+
+void _segmentSummary(const _window_t *window, const _total_t *total, displayStatsSummary_t *summary)
+{
+    _windowSummary(window, summary);
+    if (total->count) {
+        summary->avg = (uint32_t)(total->sum / total->count);
+        summary->max = total->max;
+    }
+}
+
+uint32_t _memUsed(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+void _createOverlay(void)
+{
+    overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_50, LV_PART_MAIN);
+    lv_obj_set_style_text_color(overlay, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(overlay, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_align(overlay, LV_ALIGN_TOP_RIGHT, 0, 0);
+    lv_label_set_text(overlay, "");
+}
+
+void _updateOverlay(void)
+{
+    lv_label_set_text_fmt(overlay, "%lu FPS\nR %lu/%lu us\nF %lu/%lu us\nM %lu%% %lu%%",
+                          (unsigned long)report.fps,
+                          (unsigned long)report.renderUs.avg, (unsigned long)report.renderUs.p95,
+                          (unsigned long)report.flushUs.avg, (unsigned long)report.flushUs.p95,
+                          (unsigned long)report.memUsedPct, (unsigned long)report.memFragPct);
+}
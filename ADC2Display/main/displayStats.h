@@ -0,0 +1,118 @@
+/// \file		displayStats.h
+///
+/// \brief	Frame timing and LVGL memory instrumentation
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef DISPLAY_STATS_H
+#define DISPLAY_STATS_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    uint32_t avg;
+    uint32_t p50;
+    uint32_t p95;
+    uint32_t max;
+} displayStatsSummary_t;
+
+typedef struct {
+    uint32_t fps;
+    uint32_t dmaPerSec;
+    displayStatsSummary_t renderUs;     // lv_timer_handler() duration
+    displayStatsSummary_t flushUs;      // flush callback entry to DMA completion
+    uint32_t memUsedPct;
+    uint32_t memFragPct;
+    uint32_t memMaxUsed;
+    uint32_t memFreeBiggest;
+} displayStatsReport_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Reset the counters and start collecting
+ *
+ * The hooks do nothing until this is called.
+ *
+ * @param overlay Show the numbers on the LVGL top layer
+ */
+void displayStatsInit(bool overlay);
+
+void displayStatsRenderBegin(void);
+void displayStatsRenderEnd(void);
+
+/**
+ * @brief Called on entry of the LVGL flush callback
+ *
+ * @param last True for the last flush of a frame
+ */
+void displayStatsFlushBegin(bool last);
+
+/**
+ * @brief Called when a flush has left the draw buffer, usually from the ISR
+ */
+void displayStatsFlushDone(void);
+
+/**
+ * @brief Called from the ISR for every color transfer finished by the panel IO
+ */
+void displayStatsDmaDone(void);
+
+/**
+ * @brief Publish the rolling numbers once per period
+ *
+ * Call from the task owning LVGL, after lv_timer_handler().
+ */
+void displayStatsProcess(void);
+
+void displayStatsGetReport(displayStatsReport_t *report);
+
+/**
+ * @brief Start measuring a segment, e.g. one benchmark scene
+ *
+ * Average and max of the segment cover all of its frames, p50 and p95 only
+ * the last 64 (the rolling window). memMaxUsed is the peak LVGL pool use of
+ * the segment, not since boot; while a segment is open the pool is sampled
+ * after every frame.
+ */
+void displayStatsSegmentBegin(void);
+
+/**
+ * @brief Numbers of the segment since displayStatsSegmentBegin()
+ */
+void displayStatsSegmentEnd(displayStatsReport_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_STATS_H
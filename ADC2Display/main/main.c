@@ -22,6 +22,7 @@
 #include "power_driver.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "nvs_flash.h"
 #include "displayHandler.h"
 #include "adcHandler.h"
 
@@ -64,6 +65,14 @@ void app_main(void)
         ESP_LOGE(TAG, "ERROR :No find PMU ....");
     }
 
+    // NVS holds the display calibration
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(err);
+
     // Display Driver Initialize
     displayHandlerInit();
 
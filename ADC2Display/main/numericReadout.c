@@ -0,0 +1,384 @@
+/// \file		numericReadout.c
+///
+/// \brief	Numeric readout drawn from a pre-rendered glyph atlas
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "lvgl.h"
+#include "tft_driver.h"
+#include "displayMem.h"
+#include "numericReadout.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#define READOUT_MAX                 4
+#define READOUT_MAX_CELLS           12
+#define READOUT_TRANS_TIMEOUT_MS    100
+
+// Characters kept in the atlas, in atlas order
+#define READOUT_GLYPHS              "0123456789-. "
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+struct numericReadout_s {
+    lv_obj_t *obj;
+    lv_area_t area;                 // Where the characters were last drawn
+    uint8_t cells;
+    uint8_t decimals;
+    lv_coord_t cellW;
+    lv_coord_t cellH;
+    lv_color_t *atlas;              // One cellW x cellH bitmap per glyph
+    lv_color_t *blitBuf;            // DMA buffer for one run of cells
+    uint32_t blitSeq;
+    bool blitPending;
+    bool dirty;                     // Redraw every cell on the next refresh
+    char text[READOUT_MAX_CELLS];
+    char shown[READOUT_MAX_CELLS];
+};
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Render every glyph of READOUT_GLYPHS into the atlas
+ */
+static void _renderAtlas(numericReadout_t *readout, const lv_font_t *font, lv_color_t fg, lv_color_t bg);
+
+static void _renderGlyph(lv_color_t *cell, lv_coord_t cellW, lv_coord_t cellH, const lv_font_t *font,
+                         uint32_t letter, lv_color_t fg, lv_color_t bg);
+
+/**
+ * @brief Right aligned text of \p value, dashes when it doesn't fit
+ */
+static void _format(const numericReadout_t *readout, int32_t value, char *out);
+
+static int _glyphIndex(char c);
+
+static void _refreshOne(numericReadout_t *readout);
+
+/**
+ * @brief Send cells [first, last] as one window
+ */
+static void _blitRun(numericReadout_t *readout, int first, int last);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "numericReadout";
+
+static numericReadout_t *readouts[READOUT_MAX];
+
+static numericReadoutBlitCb_t blitCb = NULL;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+numericReadout_t *numericReadoutCreate(lv_obj_t *parent, const lv_font_t *font, uint8_t cells, uint8_t decimals,
+                                       lv_color_t fg, lv_color_t bg)
+{
+    int slot = 0;
+    while (slot < READOUT_MAX && readouts[slot]) {
+        slot++;
+    }
+    if (slot == READOUT_MAX || cells == 0 || cells > READOUT_MAX_CELLS) {
+        ESP_LOGE(TAG, "Unable to create a readout of %u cells", cells);
+        return NULL;
+    }
+    // The decimals, the point and one digit before it must fit
+    if (decimals && decimals + 1 >= cells) {
+        ESP_LOGE(TAG, "%u decimals don't fit in %u cells", decimals, cells);
+        return NULL;
+    }
+
+    numericReadout_t *readout = calloc(1, sizeof(numericReadout_t));
+    if (!readout) {
+        return NULL;
+    }
+    readout->cells = cells;
+    readout->decimals = decimals;
+
+    // Fixed cell width so the characters never move when the value changes
+    lv_font_glyph_dsc_t glyph;
+    for (const char *c = READOUT_GLYPHS; *c; c++) {
+        if (lv_font_get_glyph_dsc(font, &glyph, *c, '\0') && glyph.adv_w > readout->cellW) {
+            readout->cellW = glyph.adv_w;
+        }
+    }
+    readout->cellH = lv_font_get_line_height(font);
+
+    size_t cellPixels = (size_t)readout->cellW * readout->cellH;
+    readout->atlas = displayMemAlloc(cellPixels * (sizeof(READOUT_GLYPHS) - 1) * sizeof(lv_color_t));
+    readout->blitBuf = displayMemDmaAlloc(cellPixels * cells * sizeof(lv_color_t));
+    if (!readout->atlas || !readout->blitBuf) {
+        ESP_LOGE(TAG, "No memory for the glyph atlas");
+        numericReadoutDelete(readout);
+        return NULL;
+    }
+    _renderAtlas(readout, font, fg, bg);
+
+    // LVGL paints the background, the characters are blitted over it
+    readout->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(readout->obj);
+    lv_obj_set_style_bg_color(readout->obj, bg, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(readout->obj, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_size(readout->obj, readout->cellW * cells, readout->cellH);
+    lv_obj_clear_flag(readout->obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+    memset(readout->text, ' ', sizeof(readout->text));
+    readout->dirty = true;
+    readouts[slot] = readout;
+
+    return readout;
+}
+
+void numericReadoutDelete(numericReadout_t *readout)
+{
+    if (!readout) {
+        return;
+    }
+    for (int i = 0; i < READOUT_MAX; i++) {
+        if (readouts[i] == readout) {
+            readouts[i] = NULL;
+        }
+    }
+    if (readout->blitPending) {
+        display_wait_trans_done(readout->blitSeq, READOUT_TRANS_TIMEOUT_MS);
+    }
+    if (readout->obj) {
+        lv_obj_del(readout->obj);
+    }
+    displayMemFree(readout->atlas);
+    displayMemFree(readout->blitBuf);
+    free(readout);
+}
+
+lv_obj_t *numericReadoutGetObj(numericReadout_t *readout)
+{
+    return readout->obj;
+}
+
+void numericReadoutSetValue(numericReadout_t *readout, int32_t value)
+{
+    _format(readout, value, readout->text);
+}
+
+void numericReadoutRefresh(void)
+{
+    for (int i = 0; i < READOUT_MAX; i++) {
+        if (readouts[i]) {
+            _refreshOne(readouts[i]);
+        }
+    }
+}
+
+void numericReadoutAreaFlushed(const lv_area_t *area)
+{
+    for (int i = 0; i < READOUT_MAX; i++) {
+        if (readouts[i] && _lv_area_is_on(area, &readouts[i]->area)) {
+            readouts[i]->dirty = true;
+        }
+    }
+}
+
+void numericReadoutSetBlitCb(numericReadoutBlitCb_t cb)
+{
+    blitCb = cb;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _renderAtlas(numericReadout_t *readout, const lv_font_t *font, lv_color_t fg, lv_color_t bg)
+{
+    size_t cellPixels = (size_t)readout->cellW * readout->cellH;
+    for (int g = 0; READOUT_GLYPHS[g]; g++) {
+        _renderGlyph(&readout->atlas[g * cellPixels], readout->cellW, readout->cellH, font,
+                     READOUT_GLYPHS[g], fg, bg);
+    }
+}
+
+void _renderGlyph(lv_color_t *cell, lv_coord_t cellW, lv_coord_t cellH, const lv_font_t *font,
+                  uint32_t letter, lv_color_t fg, lv_color_t bg)
+{
+    for (int i = 0; i < cellW * cellH; i++) {
+        cell[i] = bg;
+    }
+
+    lv_font_glyph_dsc_t glyph;
+    if (!lv_font_get_glyph_dsc(font, &glyph, letter, '\0') || glyph.box_w == 0) {
+        return;
+    }
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, letter);
+    if (!bitmap || (glyph.bpp != 1 && glyph.bpp != 2 && glyph.bpp != 4 && glyph.bpp != 8)) {
+        return;
+    }
+
+    // Same placement as the LVGL label renderer, centered in the cell
+    int x0 = (cellW - glyph.adv_w) / 2 + glyph.ofs_x;
+    int y0 = (lv_font_get_line_height(font) - font->base_line) - glyph.box_h - glyph.ofs_y;
+    uint32_t mask = (1u << glyph.bpp) - 1;
+
+    // Glyph bitmaps are a continuous bit stream, rows are not byte aligned
+    for (int y = 0; y < glyph.box_h; y++) {
+        for (int x = 0; x < glyph.box_w; x++) {
+            int cx = x0 + x;
+            int cy = y0 + y;
+            if (cx < 0 || cx >= cellW || cy < 0 || cy >= cellH) {
+                continue;
+            }
+            uint32_t bit = (uint32_t)(y * glyph.box_w + x) * glyph.bpp;
+            uint32_t value = (bitmap[bit >> 3] >> (8 - glyph.bpp - (bit & 7))) & mask;
+            if (value) {
+                cell[cy * cellW + cx] = lv_color_mix(fg, bg, value * 255 / mask);
+            }
+        }
+    }
+}
+
+void _format(const numericReadout_t *readout, int32_t value, char *out)
+{
+    // A point and a digit can go in at once past the cells, then the sign
+    char reversed[READOUT_MAX_CELLS + 3];
+    uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    int len = 0;
+    int digit = 0;
+
+    // At least one digit before the decimal point. Stops as soon as it
+    // can't fit, the value is shown as dashes then.
+    do {
+        if (readout->decimals && digit == readout->decimals) {
+            reversed[len++] = '.';
+        }
+        reversed[len++] = '0' + magnitude % 10;
+        magnitude /= 10;
+        digit++;
+    } while ((magnitude || digit <= readout->decimals) && len <= readout->cells);
+
+    if (value < 0 && len <= readout->cells) {
+        reversed[len++] = '-';
+    }
+
+    if (len > readout->cells) {
+        memset(out, '-', readout->cells);
+        return;
+    }
+
+    int pad = readout->cells - len;
+    memset(out, ' ', pad);
+    for (int i = 0; i < len; i++) {
+        out[pad + i] = reversed[len - 1 - i];
+    }
+}
+
+int _glyphIndex(char c)
+{
+    const char *found = strchr(READOUT_GLYPHS, c);
+    return (found && c) ? found - READOUT_GLYPHS : sizeof(READOUT_GLYPHS) - 2;
+}
+
+void _refreshOne(numericReadout_t *readout)
+{
+    if (lv_obj_has_flag(readout->obj, LV_OBJ_FLAG_HIDDEN)) {
+        readout->dirty = true;
+        return;
+    }
+
+    lv_area_t area;
+    lv_obj_update_layout(readout->obj);
+    lv_obj_get_coords(readout->obj, &area);
+    if (memcmp(&area, &readout->area, sizeof(area)) != 0) {
+        readout->area = area;
+        readout->dirty = true;
+    }
+
+    // Blits are not clipped, a readout partly off screen is not drawn
+    lv_disp_t *disp = lv_obj_get_disp(readout->obj);
+    if (area.x1 < 0 || area.y1 < 0 ||
+        area.x2 >= lv_disp_get_hor_res(disp) || area.y2 >= lv_disp_get_ver_res(disp)) {
+        return;
+    }
+
+    bool all = readout->dirty;
+    readout->dirty = false;
+
+    int first = -1;
+    for (int i = 0; i <= readout->cells; i++) {
+        bool changed = i < readout->cells && (all || readout->text[i] != readout->shown[i]);
+        if (changed && first < 0) {
+            first = i;
+        } else if (!changed && first >= 0) {
+            _blitRun(readout, first, i - 1);
+            first = -1;
+        }
+    }
+}
+
+void _blitRun(numericReadout_t *readout, int first, int last)
+{
+    // The buffer is packed in place in 12 bpp mode, so wait before refilling it
+    if (readout->blitPending && !display_wait_trans_done(readout->blitSeq, READOUT_TRANS_TIMEOUT_MS)) {
+        ESP_LOGW(TAG, "Blit transfer timed out");
+    }
+    readout->blitPending = false;
+
+    size_t cellPixels = (size_t)readout->cellW * readout->cellH;
+    int count = last - first + 1;
+    lv_color_t *dst = readout->blitBuf;
+
+    for (lv_coord_t y = 0; y < readout->cellH; y++) {
+        for (int i = first; i <= last; i++) {
+            const lv_color_t *src = &readout->atlas[_glyphIndex(readout->text[i]) * cellPixels + y * readout->cellW];
+            memcpy(dst, src, readout->cellW * sizeof(lv_color_t));
+            dst += readout->cellW;
+        }
+    }
+
+    uint16_t x = readout->area.x1 + first * readout->cellW;
+    uint16_t y = readout->area.y1;
+    if (blitCb) {
+        // Before the push, in 12 bpp mode it packs the buffer in place
+        const lv_area_t blitArea = { x, y, x + count * readout->cellW - 1, y + readout->cellH - 1 };
+        blitCb(&blitArea, readout->blitBuf);
+    }
+    if (display_push_colors(x, y, x + count * readout->cellW, y + readout->cellH, (uint16_t *)readout->blitBuf) != ESP_OK) {
+        // Try again on the next refresh
+        readout->dirty = true;
+        return;
+    }
+    readout->blitSeq = display_get_trans_queued();
+    readout->blitPending = true;
+    memcpy(&readout->shown[first], &readout->text[first], count);
+}
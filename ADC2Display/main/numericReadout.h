@@ -0,0 +1,101 @@
+/// \file		numericReadout.h
+///
+/// \brief	Numeric readout drawn from a pre-rendered glyph atlas
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef NUMERIC_READOUT_H
+#define NUMERIC_READOUT_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                         TYPEDEFS AND STRUCTURES                          //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct numericReadout_s numericReadout_t;
+
+/**
+ * @brief Called with every run of cells right before it is sent to the panel
+ */
+typedef void (*numericReadoutBlitCb_t)(const lv_area_t *area, const lv_color_t *colors);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Create a readout of \p cells fixed width characters
+ *
+ * The digits, sign and decimal point of \p font are rendered once into an
+ * RGB565 atlas. LVGL only owns a placeholder object filled with \p bg, used
+ * for layout; the characters themselves are sent straight to the panel by
+ * numericReadoutRefresh(). The placeholder must not be covered by other
+ * objects.
+ *
+ * @param parent Parent of the placeholder object
+ * @param font Font of the characters
+ * @param cells Number of characters, sign and decimal point included
+ * @param decimals Digits shown after the decimal point, at most cells - 2
+ * @param fg Text color
+ * @param bg Background color
+ */
+numericReadout_t *numericReadoutCreate(lv_obj_t *parent, const lv_font_t *font, uint8_t cells, uint8_t decimals,
+                                       lv_color_t fg, lv_color_t bg);
+
+void numericReadoutDelete(numericReadout_t *readout);
+
+/**
+ * @brief Placeholder object, to align or move the readout
+ */
+lv_obj_t *numericReadoutGetObj(numericReadout_t *readout);
+
+/**
+ * @brief Set the value, scaled by 10^decimals
+ *
+ * Only formats the text, nothing is sent until numericReadoutRefresh().
+ * Values that don't fit are shown as dashes.
+ */
+void numericReadoutSetValue(numericReadout_t *readout, int32_t value);
+
+/**
+ * @brief Blit the characters that changed for every readout
+ *
+ * Call from the task owning LVGL, after lv_timer_handler().
+ */
+void numericReadoutRefresh(void);
+
+/**
+ * @brief Tell the readouts an area was flushed by LVGL
+ *
+ * Readouts overlapping \p area were painted over with their background and
+ * are redrawn in full on the next refresh. Call from the flush callback.
+ */
+void numericReadoutAreaFlushed(const lv_area_t *area);
+
+/**
+ * @brief Follow the blits, e.g. to keep a copy of the frame up to date
+ */
+void numericReadoutSetBlitCb(numericReadoutBlitCb_t cb);
+
+#endif // NUMERIC_READOUT_H
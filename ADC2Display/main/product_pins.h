@@ -23,6 +23,9 @@
 #define BOARD_TFT_DC         (16)
 #define BOARD_TFT_BL         (4)
 
+#define BOARD_BUTTON_1       (0)
+#define BOARD_BUTTON_2       (35)
+
 #define AMOLED_WIDTH         (135)
 #define AMOLED_HEIGHT        (240)
 
@@ -32,6 +35,43 @@
 
 #define DISPLAY_FULLRESH     false
 
+// Search pixel clock, draw buffer size and queue depth at boot and store
+// the fastest stable combination in NVS for the following boots
+#define DISPLAY_BENCHMARK_ON_BOOT   false
+
+// Pixel format on the SPI bus: 16 (RGB565) or 12 (RGB444, a quarter fewer
+// bytes per frame at the cost of colour depth and a packing pass)
+#define DISPLAY_BITS_PER_PIXEL      16
+
+// Merge the areas LVGL flushes in one frame before sending them, using a
+// shadow copy of the frame. Tile diff also skips tiles whose content did not
+// change since the last frame.
+#define DISPLAY_COALESCE            true
+#define DISPLAY_COALESCE_TILE_DIFF  false
+
+// Log FPS, render/flush time percentiles and LVGL memory use once per second.
+// The overlay shows the same numbers on the top layer of the screen.
+#define DISPLAY_STATS               true
+#define DISPLAY_STATS_OVERLAY       false
+
+// Time label updates against glyph atlas readout updates once at startup
+#define DISPLAY_READOUT_BENCHMARK   false
+
+// Measure small-area updates per second with and without the panel window
+// cache once at startup
+#define DISPLAY_WINDOW_BENCHMARK    false
+
+// Orientation at boot, see display_rotation_t. Rotation is done by the panel
+// (MADCTL), LVGL software rotation stays off.
+#define DISPLAY_ROTATION            DISPLAY_ROTATION_0
+
+// After this long without a button press or LVGL input the backlight dims,
+// then the panel sleeps with the backlight off, then rendering stops too.
+// 0 disables the step.
+#define DISPLAY_DIM_TIMEOUT_MS      (30 * 1000)
+#define DISPLAY_SLEEP_TIMEOUT_MS    (2 * 60 * 1000)
+#define DISPLAY_OFF_TIMEOUT_MS      (5 * 60 * 1000)
+
 
 
 
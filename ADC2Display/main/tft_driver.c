@@ -7,17 +7,21 @@
  *
  */
 #include <sdkconfig.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_vendor.h"
 #include "driver/gpio.h"
 #include "product_pins.h"
 #include "esp_log.h"
+#include "esp_check.h"
 #include "esp_idf_version.h"
 #include "driver/spi_master.h"
-#include "lvgl.h"
+#include "esp_lcd_panel_st7735.h"
+#include "tft_driver.h"
 
-#define EXAMPLE_LCD_PIXEL_CLOCK_HZ     (27 * 1000 * 1000)
 #define EXAMPLE_LCD_CMD_BITS           8
 #define EXAMPLE_LCD_PARAM_BITS         8
 #define LCD_HOST                       SPI2_HOST
@@ -25,23 +29,115 @@
 static const char *TAG = "TFT";
 static esp_lcd_panel_io_handle_t io_handle = NULL;
 static esp_lcd_panel_handle_t panel_handle = NULL;
-extern lv_disp_drv_t disp_drv;
+static display_config_t display_config = DISPLAY_CONFIG_DEFAULT();
+static display_flush_ready_cb_t flush_ready_cb = NULL;
+static void *flush_ready_ctx = NULL;
+static display_rotation_t display_rotation = DISPLAY_ROTATION_0;
+
+// The ST7789 frame memory is 240x320 and the 135x240 glass sits off centre
+// in it, so the offsets depend on which edges the mirrors start counting from
+typedef struct {
+    bool swap_xy;
+    bool mirror_x;
+    bool mirror_y;
+    uint8_t x_gap;
+    uint8_t y_gap;
+} display_orientation_t;
+
+static const display_orientation_t display_orientations[] = {
+    [DISPLAY_ROTATION_0]   = { true,  false, true,  40, 53 },
+    [DISPLAY_ROTATION_90]  = { false, false, false, 52, 40 },
+    [DISPLAY_ROTATION_180] = { true,  true,  false, 40, 52 },
+    [DISPLAY_ROTATION_270] = { false, true,  true,  53, 40 },
+};
+
+// Every color transfer gets a sequence number when queued; the ISR counts
+// completions so callers can wait for a given transfer without reading back.
+static SemaphoreHandle_t trans_done_sem = NULL;
+static volatile uint32_t trans_queued = 0;
+static volatile uint32_t trans_done = 0;
+
+esp_err_t display_push_colors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+{
+    if (display_config.bits_per_pixel == 12) {
+        // Pack in place, the panel reads 3 bytes for every 2 pixels
+        esp_lcd_st7735_pack_rgb444(data, (uint8_t *)data, (size_t)(width - x) * (hight - y), LV_COLOR_16_SWAP);
+    }
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, x, y, width, hight, data);
+    if (ret == ESP_OK) {
+        trans_queued++;
+    }
+    return ret;
+}
+
+static bool display_notify_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t need_yield = pdFALSE;
+
+    trans_done++;
+    if (flush_ready_cb) {
+        flush_ready_cb(flush_ready_ctx);
+    }
+    xSemaphoreGiveFromISR(trans_done_sem, &need_yield);
+    return need_yield == pdTRUE;
+}
+
+void display_set_flush_ready_cb(display_flush_ready_cb_t cb, void *user_ctx)
+{
+    flush_ready_ctx = user_ctx;
+    flush_ready_cb = cb;
+}
+
+uint32_t display_get_trans_queued(void)
+{
+    return trans_queued;
+}
 
-void display_push_colors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data)
+uint32_t display_get_trans_done(void)
 {
-    esp_lcd_panel_draw_bitmap(panel_handle, x, y, width, hight, data);
+    return trans_done;
 }
 
-bool display_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+bool display_wait_trans_done(uint32_t seq, uint32_t timeout_ms)
 {
-    lv_disp_flush_ready(&disp_drv);
-    return false;
+    TickType_t start = xTaskGetTickCount();
+    // Sequence numbers wrap, so compare the signed distance
+    while ((int32_t)(trans_done - seq) < 0) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= pdMS_TO_TICKS(timeout_ms)) {
+            return false;
+        }
+        xSemaphoreTake(trans_done_sem, pdMS_TO_TICKS(timeout_ms) - elapsed);
+    }
+    return true;
+}
+
+const display_config_t *display_get_config(void)
+{
+    return &display_config;
 }
 
 void display_init()
 {
+    const display_config_t config = DISPLAY_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(display_init_with_config(&config));
+}
+
+esp_err_t display_init_with_config(const display_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(config && config->draw_buf_lines && config->trans_queue_depth, ESP_ERR_INVALID_ARG, TAG, "invalid config");
+    ESP_RETURN_ON_FALSE(config->bits_per_pixel == 16 || config->bits_per_pixel == 12, ESP_ERR_INVALID_ARG, TAG, "unsupported pixel width");
 
     ESP_LOGI(TAG, "============T-Display ESP32============");
+    ESP_LOGI(TAG, "pclk %lu Hz, %u lines, queue depth %u, %u bpp",
+             (unsigned long)config->pclk_hz, config->draw_buf_lines, config->trans_queue_depth, config->bits_per_pixel);
+
+    if (!trans_done_sem) {
+        trans_done_sem = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(trans_done_sem, ESP_ERR_NO_MEM, TAG, "no mem for transfer semaphore");
+    }
+    trans_queued = 0;
+    trans_done = 0;
 
     ESP_LOGI(TAG, "Initialize SPI bus");
     spi_bus_config_t buscfg = {
@@ -50,67 +146,119 @@ void display_init()
         .miso_io_num = BOARD_SPI_MISO,
         .quadwp_io_num = -1,
         .quadhd_io_num = -1,
-        .max_transfer_sz = AMOLED_HEIGHT * 80 * sizeof(uint16_t),
+        .max_transfer_sz = AMOLED_HEIGHT * config->draw_buf_lines * sizeof(uint16_t),
     };
-    ESP_ERROR_CHECK(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO));
+    ESP_RETURN_ON_ERROR(spi_bus_initialize(LCD_HOST, &buscfg, SPI_DMA_CH_AUTO), TAG, "spi bus init failed");
 
     ESP_LOGI(TAG, "Install panel IO");
     esp_lcd_panel_io_spi_config_t io_config = {
         .dc_gpio_num = BOARD_TFT_DC,
         .cs_gpio_num = BOARD_TFT_CS,
-        .pclk_hz = EXAMPLE_LCD_PIXEL_CLOCK_HZ,
-        .lcd_cmd_bits = 8,
-        .lcd_param_bits = 8,
+        .pclk_hz = config->pclk_hz,
+        .lcd_cmd_bits = EXAMPLE_LCD_CMD_BITS,
+        .lcd_param_bits = EXAMPLE_LCD_PARAM_BITS,
         .spi_mode = 0,
-        .trans_queue_depth = 10,
-        .on_color_trans_done = display_notify_lvgl_flush_ready
+        .trans_queue_depth = config->trans_queue_depth,
+        .on_color_trans_done = display_notify_flush_ready
     };
 
+    esp_err_t ret = ESP_OK;
+
     // Attach the LCD to the SPI bus
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle));
+    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)LCD_HOST, &io_config, &io_handle), err, TAG, "panel io failed");
 
     esp_lcd_panel_dev_config_t panel_config = {
         .reset_gpio_num = BOARD_TFT_RST,
         .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
-        .bits_per_pixel = 16,
+        .bits_per_pixel = config->bits_per_pixel,
     };
 
+    // The in-tree ST7735 driver speaks the same command set as the ST7789 and
+    // also supports the 12 bpp COLMOD the IDF driver doesn't
     ESP_LOGI(TAG, "Install ST7789 panel driver");
-    ESP_ERROR_CHECK(esp_lcd_new_panel_st7789(io_handle, &panel_config, &panel_handle));
+    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_st7735(io_handle, &panel_config, &panel_handle), err, TAG, "panel driver failed");
 
-    ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_reset(panel_handle), err, TAG, "panel reset failed");
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_init(panel_handle), err, TAG, "panel init failed");
 
-    ESP_ERROR_CHECK(esp_lcd_panel_invert_color(panel_handle, true));
-    esp_lcd_panel_swap_xy(panel_handle, true);
-    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, false, true));
-    esp_lcd_panel_set_gap(panel_handle, 40, 53);
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_invert_color(panel_handle, true), err, TAG, "panel invert failed");
+    ESP_GOTO_ON_ERROR(display_set_rotation(display_rotation), err, TAG, "panel rotation failed");
 
-    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true));
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_disp_on_off(panel_handle, true), err, TAG, "panel on failed");
 
-    ESP_LOGI(TAG, "Turn on LCD backlight");
-    gpio_config_t bk_gpio_config = {
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = 1ULL << BOARD_TFT_BL
-    };
-    ESP_ERROR_CHECK(gpio_config(&bk_gpio_config));
+    // The backlight is driven by backlight.c
 
-    ESP_LOGI(TAG, "backlight = 1");
-    gpio_set_level(BOARD_TFT_BL, 1);
+    display_config = *config;
+    return ESP_OK;
 
+err:
+    display_deinit();
+    return ret;
 }
 
+esp_err_t display_set_window_cache(bool enable)
+{
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_STATE, TAG, "display not initialized");
+    return esp_lcd_st7735_set_window_cache(panel_handle, enable);
+}
 
+void display_get_window_stats(uint32_t *sent, uint32_t *skipped)
+{
+    *sent = 0;
+    *skipped = 0;
+    if (panel_handle) {
+        esp_lcd_st7735_get_window_stats(panel_handle, sent, skipped);
+    }
+}
 
+esp_err_t display_set_rotation(display_rotation_t rotation)
+{
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_STATE, TAG, "display not initialized");
+    ESP_RETURN_ON_FALSE(rotation <= DISPLAY_ROTATION_270, ESP_ERR_INVALID_ARG, TAG, "invalid rotation");
+
+    const display_orientation_t *o = &display_orientations[rotation];
+    ESP_RETURN_ON_ERROR(esp_lcd_st7735_set_orientation(panel_handle, o->swap_xy, o->mirror_x, o->mirror_y,
+                                                       o->x_gap, o->y_gap), TAG, "panel orientation failed");
+    display_rotation = rotation;
+    ESP_LOGI(TAG, "rotation %d", rotation * 90);
+    return ESP_OK;
+}
 
+display_rotation_t display_get_rotation(void)
+{
+    return display_rotation;
+}
 
+void display_get_resolution(uint16_t *hor_res, uint16_t *ver_res)
+{
+    bool landscape = display_orientations[display_rotation].swap_xy;
+    *hor_res = landscape ? AMOLED_HEIGHT : AMOLED_WIDTH;
+    *ver_res = landscape ? AMOLED_WIDTH : AMOLED_HEIGHT;
+}
 
+esp_err_t display_set_panel_power(bool on)
+{
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_STATE, TAG, "display not initialized");
+    if (on) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_sleep(panel_handle, false), TAG, "sleep out failed");
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(panel_handle, true), TAG, "display on failed");
+    } else {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(panel_handle, false), TAG, "display off failed");
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_sleep(panel_handle, true), TAG, "sleep in failed");
+    }
+    ESP_LOGI(TAG, "panel %s", on ? "on" : "asleep");
+    return ESP_OK;
+}
 
-
-
-
-
-
-
-
-
+void display_deinit(void)
+{
+    if (panel_handle) {
+        esp_lcd_panel_del(panel_handle);
+        panel_handle = NULL;
+    }
+    if (io_handle) {
+        esp_lcd_panel_io_del(io_handle);
+        io_handle = NULL;
+    }
+    spi_bus_free(LCD_HOST);
+}
@@ -17,8 +17,86 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Bus and buffer parameters the display is brought up with
+ *
+ * draw_buf_lines is expressed in lines of the landscape frame (AMOLED_HEIGHT
+ * pixels each) and sizes both the SPI max transfer and the LVGL draw buffers.
+ * bits_per_pixel is the format on the wire, 16 (RGB565) or 12 (RGB444).
+ */
+typedef struct {
+    uint32_t pclk_hz;
+    uint16_t draw_buf_lines;
+    uint8_t trans_queue_depth;
+    uint8_t bits_per_pixel;
+} display_config_t;
+
+#define DISPLAY_CONFIG_DEFAULT()        \
+    {                                   \
+        .pclk_hz = 27 * 1000 * 1000,    \
+        .draw_buf_lines = 20,           \
+        .trans_queue_depth = 10,        \
+        .bits_per_pixel = 16,           \
+    }
+
+/**
+ * @brief Orientation of the frame, clockwise from the landscape layout
+ *
+ * 0 and 180 are AMOLED_HEIGHT x AMOLED_WIDTH, 90 and 270 are portrait.
+ */
+typedef enum {
+    DISPLAY_ROTATION_0,
+    DISPLAY_ROTATION_90,
+    DISPLAY_ROTATION_180,
+    DISPLAY_ROTATION_270,
+} display_rotation_t;
+
+/**
+ * @brief Called from the SPI ISR every time a color transfer has been sent
+ */
+typedef void (*display_flush_ready_cb_t)(void *user_ctx);
+
 void display_init();
-void display_push_colors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+esp_err_t display_init_with_config(const display_config_t *config);
+void display_deinit(void);
+const display_config_t *display_get_config(void);
+void display_set_flush_ready_cb(display_flush_ready_cb_t cb, void *user_ctx);
+/**
+ * @brief Send RGB565 pixels to the panel
+ *
+ * In 12 bpp mode the pixels are packed to RGB444 in place before the transfer,
+ * so the content of \p data is consumed and must be regenerated before reuse.
+ */
+esp_err_t display_push_colors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
+/**
+ * @brief Skip the address window commands when a draw reuses the last window
+ *
+ * On by default. The stats count the CASET/RASET commands sent and skipped.
+ */
+esp_err_t display_set_window_cache(bool enable);
+void display_get_window_stats(uint32_t *sent, uint32_t *skipped);
+/**
+ * @brief Display off and sleep in, or sleep out and display on
+ *
+ * The panel keeps its frame memory while asleep.
+ */
+esp_err_t display_set_panel_power(bool on);
+/**
+ * @brief Rotate through the panel address mode (MADCTL) and window offsets
+ *
+ * No pixel is copied or rotated in software, the frame memory is just scanned
+ * in another order. Queued transfers finish before the switch, content drawn
+ * before it must be redrawn.
+ */
+esp_err_t display_set_rotation(display_rotation_t rotation);
+display_rotation_t display_get_rotation(void);
+void display_get_resolution(uint16_t *hor_res, uint16_t *ver_res);
+uint32_t display_get_trans_queued(void);
+/**
+ * @brief Transfers completed so far, also valid in the flush ready callback
+ */
+uint32_t display_get_trans_done(void);
+bool display_wait_trans_done(uint32_t seq, uint32_t timeout_ms);
 #ifdef __cplusplus
 }
 #endif
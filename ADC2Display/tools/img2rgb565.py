@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Convert PNG images into RLE compressed RGB565 C sources for displayImage.
+
+Every image becomes <name>.c with a displayImage_t <name> and an lv_img_dsc_t
+<name>_img, and assets.h declares all of them. Pixels are stored in the byte
+order LVGL uses with CONFIG_LV_COLOR_16_SWAP, so they go to the panel as they
+are. Each line is encoded on its own, see displayImage.h for the format.
+
+    python img2rgb565.py --out-dir build/assets images/*.png
+"""
+
+import argparse
+import os
+import re
+import sys
+
+MAX_PACKET = 128
+RUN_BIT = 0x80
+BYTES_PER_LINE = 16
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def pixel_bytes(pixel, swap):
+    # Swapped means high byte first in memory, the order the panel reads
+    if swap:
+        return bytes((pixel >> 8, pixel & 0xFF))
+    return bytes((pixel & 0xFF, pixel >> 8))
+
+
+def encode_literal(out, literal, swap):
+    for i in range(0, len(literal), MAX_PACKET):
+        chunk = literal[i:i + MAX_PACKET]
+        out.append(len(chunk) - 1)
+        for p in chunk:
+            out.extend(pixel_bytes(p, swap))
+
+
+def encode_line(pixels, swap):
+    """Runs of two or more equal pixels, literals in between."""
+    out = bytearray()
+    literal = []
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < MAX_PACKET and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            encode_literal(out, literal, swap)
+            literal = []
+            out.append(RUN_BIT | (run - 1))
+            out.extend(pixel_bytes(pixels[i], swap))
+        else:
+            literal.append(pixels[i])
+        i += run
+    encode_literal(out, literal, swap)
+    return bytes(out)
+
+
+def decode_line(data, width, swap):
+    """Reference decoder, used to check every line after encoding."""
+    pixels = []
+    i = 0
+    while i < len(data):
+        control = data[i]
+        count = (control & 0x7F) + 1
+        i += 1
+        raw = data[i:i + 2 if control & RUN_BIT else i + 2 * count]
+        values = [int.from_bytes(raw[j:j + 2], "big" if swap else "little") for j in range(0, len(raw), 2)]
+        pixels += values * count if control & RUN_BIT else values
+        i += len(raw)
+    if len(pixels) != width:
+        raise ValueError("line decodes to %d pixels, expected %d" % (len(pixels), width))
+    return pixels
+
+
+def load_pixels(path, background):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("img2rgb565: Pillow is required, install it with 'pip install pillow'")
+
+    image = Image.open(path).convert("RGBA")
+    # No alpha in the output, transparent areas take the background color
+    flat = Image.new("RGBA", image.size, background + (255,))
+    flat.alpha_composite(image)
+    width, height = flat.size
+    data = [rgb565(r, g, b) for r, g, b, _ in flat.getdata()]
+    return width, height, [data[y * width:(y + 1) * width] for y in range(height)]
+
+
+def c_name(path):
+    """Same rule as string(MAKE_C_IDENTIFIER) + TOLOWER in main/CMakeLists.txt,
+    which names the .c files the build expects: every byte that is not an ASCII
+    letter or digit becomes '_', and a leading digit gets a '_' in front."""
+    raw = os.fsencode(os.path.splitext(os.path.basename(path))[0])
+    name = re.sub(rb"[^A-Za-z0-9]", b"_", raw).decode("ascii").lower()
+    return "_" + name if name[:1].isdigit() else name
+
+
+def write_source(path, name, source, width, height, lines, swap):
+    offsets = []
+    data = bytearray()
+    for line in lines:
+        encoded = encode_line(line, swap)
+        if decode_line(encoded, width, swap) != line:
+            raise ValueError("%s: line %d does not round trip" % (source, len(offsets)))
+        offsets.append(len(data))
+        data += encoded
+
+    with open(path, "w") as f:
+        f.write("// Generated by tools/img2rgb565.py from %s, do not edit\n" % os.path.basename(source))
+        f.write("// %ux%u, %u bytes RLE, %u bytes raw\n\n" % (width, height, len(data), width * height * 2))
+        f.write('#include "displayImage.h"\n\n')
+        f.write("static const uint8_t %s_data[%u] = {\n" % (name, len(data)))
+        for i in range(0, len(data), BYTES_PER_LINE):
+            f.write("    " + ", ".join("0x%02x" % b for b in data[i:i + BYTES_PER_LINE]) + ",\n")
+        f.write("};\n\n")
+        f.write("static const uint32_t %s_lines[%u] = {\n" % (name, height))
+        for i in range(0, height, BYTES_PER_LINE // 2):
+            f.write("    " + ", ".join("%u" % o for o in offsets[i:i + BYTES_PER_LINE // 2]) + ",\n")
+        f.write("};\n\n")
+        f.write("const displayImage_t %s = {\n" % name)
+        f.write("    .width = %u,\n    .height = %u,\n    .swapped = %s,\n" % (width, height, "true" if swap else "false"))
+        f.write("    .lines = %s_lines,\n    .data = %s_data,\n    .size = sizeof(%s_data),\n};\n\n" % (name, name, name))
+        f.write("const lv_img_dsc_t %s_img = {\n" % name)
+        f.write("    .header.cf = LV_IMG_CF_USER_ENCODED_0,\n")
+        f.write("    .header.w = %u,\n    .header.h = %u,\n" % (width, height))
+        f.write("    .data_size = sizeof(displayImage_t),\n    .data = (const uint8_t *)&%s,\n};\n" % name)
+    return len(data)
+
+
+def write_header(path, names):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/img2rgb565.py, do not edit\n")
+        f.write("#pragma once\n\n")
+        f.write('#include "displayImage.h"\n\n')
+        f.write("#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n")
+        for name in names:
+            f.write("#define ASSET_%s 1\n" % name.upper())
+            f.write("extern const displayImage_t %s;\n" % name)
+            f.write("extern const lv_img_dsc_t %s_img;\n\n" % name)
+        f.write("#ifdef __cplusplus\n}\n#endif\n")
+
+
+def parse_color(text):
+    value = int(text.lstrip("#"), 16)
+    return ((value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("images", nargs="*", help="PNG files")
+    parser.add_argument("--out-dir", required=True, help="where the .c files and assets.h are written")
+    parser.add_argument("--no-swap", action="store_true", help="little endian pixels, for CONFIG_LV_COLOR_16_SWAP=n")
+    parser.add_argument("--background", type=parse_color, default=(0, 0, 0),
+                        help="RRGGBB color behind transparent pixels, black by default")
+    args = parser.parse_args()
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    names = []
+    for source in sorted(args.images):
+        name = c_name(source)
+        if name in names:
+            sys.exit("img2rgb565: %s maps to the symbol %s twice" % (source, name))
+        width, height, lines = load_pixels(source, args.background)
+        size = write_source(os.path.join(args.out_dir, name + ".c"), name, source, width, height, lines,
+                            not args.no_swap)
+        print("img2rgb565: %s %ux%u %u -> %u bytes" % (name, width, height, width * height * 2, size))
+        names.append(name)
+    write_header(os.path.join(args.out_dir, "assets.h"), names)
+
+
+if __name__ == "__main__":
+    main()
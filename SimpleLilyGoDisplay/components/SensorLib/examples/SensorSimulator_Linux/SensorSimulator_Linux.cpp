@@ -0,0 +1,315 @@
+/**
+ * @file      SensorSimulator_Linux.cpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * Runs the QMI8658, QMC6310, BMA423, PCF8563 and XL9555 drivers on a Linux
+ * host against the register models of src/simulator, then times the common
+ * read calls. Time is virtual, the whole run takes a fraction of a second.
+ * The exit status is the number of failed checks.
+ *
+ *  make run
+ */
+#include <stdio.h>
+#include <chrono>
+#include "SensorQMI8658.hpp"
+#include "SensorQMC6310.hpp"
+#include "SensorBMA423.hpp"
+#include "SensorPCF8563.hpp"
+#include "ExtensionIOXL9555.hpp"
+#include "simulator/SimQMI8658.hpp"
+#include "simulator/SimQMC6310.hpp"
+#include "simulator/SimBMA423.hpp"
+#include "simulator/SimPCF8563.hpp"
+#include "simulator/SimXL9555.hpp"
+
+#define BENCHMARK_ROUNDS    2000
+
+static int failures = 0;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond);          \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+static SimQMI8658 simImu;
+static SimQMC6310 simMag;
+static SimBMA423 simAccel;
+static SimPCF8563 simRtc;
+static SimXL9555 simExpander;
+
+// Reads register pairs of the QMI8658 model with the SensorCommon helpers
+class PairReader : public SensorCommon<PairReader>
+{
+    friend class SensorCommon<PairReader>;
+public:
+    using SensorCommon<PairReader>::readRegisterH8L4;
+    using SensorCommon<PairReader>::readRegisterH8L4Burst;
+
+private:
+    bool initImpl()
+    {
+        return true;
+    }
+
+    int getReadMaskImpl()
+    {
+        return -1;
+    }
+};
+
+static SensorQMI8658 qmi;
+static SensorQMC6310 qmc;
+static SensorBMA423 bma;
+static SensorPCF8563 rtc;
+static ExtensionIOXL9555 io;
+
+// Lying flat with a 2 Hz wobble around x, turning at 90 dps
+static void wobble(uint64_t t_us, float *out, void *user_data)
+{
+    float amplitude = *(float *)user_data;
+    float t = t_us / 1000000.0f;
+    out[0] = amplitude * sinf(2.0f * (float)PI * 2.0f * t);
+    out[1] = 0;
+    out[2] = 1.0f;
+}
+
+static void turning(uint64_t t_us, float *out, void *user_data)
+{
+    (void)t_us;
+    (void)user_data;
+    out[0] = 0;
+    out[1] = 0;
+    out[2] = 90.0f;
+}
+
+static bool near(float a, float b, float tolerance)
+{
+    return fabsf(a - b) <= tolerance;
+}
+
+static void runQMI8658()
+{
+    printf("QMI8658\n");
+    static float amplitude = 0.25f;
+    simImu.accel.setGenerator(wobble, &amplitude);
+    simImu.gyro.setGenerator(turning);
+    simImu.setTemperature(31.5f);
+
+    CHECK(qmi.begin(QMI8658_L_SLAVE_ADDRESS, SensorSimBus::readCallback, SensorSimBus::transmitCallback));
+    CHECK(qmi.configAccelerometer(SensorQMI8658::ACC_RANGE_4G, SensorQMI8658::ACC_ODR_1000Hz) == DEV_WIRE_NONE);
+    CHECK(qmi.configGyroscope(SensorQMI8658::GYR_RANGE_256DPS, SensorQMI8658::GYR_ODR_896_8Hz) == DEV_WIRE_NONE);
+    qmi.enableAccelerometer();
+    qmi.enableGyroscope();
+
+    float ax = 0, ay = 0, az = 0, gx = 0, gy = 0, gz = 0;
+    for (int i = 0; i < 5; ++i) {
+        uint32_t start = millis();
+        while (!qmi.getDataReady() && millis() - start < 10) {
+            delayMicroseconds(100);
+        }
+        qmi.getAccelerometer(ax, ay, az);
+        qmi.getGyroscope(gx, gy, gz);
+        printf("  t=%6lu us acc %6.3f %6.3f %6.3f g  gyr %7.2f %7.2f %7.2f dps\n",
+               (unsigned long)micros(), ax, ay, az, gx, gy, gz);
+        delay(50);
+    }
+    CHECK(near(az, 1.0f, 0.01f));
+    CHECK(near(gz, 90.0f, 0.1f));
+    CHECK(near(qmi.getTemperature_C(), 31.5f, 0.01f));
+    // Steady-state polling must not touch the heap
+    CHECK(qmi.getWriteAllocations() == 0);
+
+    // Sixteen frames of accelerometer and gyroscope, 192 bytes
+    IMUdata acc[16], gyr[16];
+    CHECK(qmi.configFIFO(SensorQMI8658::FIFO_MODE_FIFO, SensorQMI8658::FIFO_SAMPLES_16) == DEV_WIRE_NONE);
+    delay(30);
+    CHECK(qmi.readFromFifo(acc, 16, gyr, 16));
+    printf("  fifo frame 0 acc z %.3f g, frame 15 gyr z %.2f dps\n", acc[0].z, gyr[15].z);
+    CHECK(near(acc[15].z, 1.0f, 0.01f) && near(gyr[0].z, 90.0f, 0.1f));
+
+#if defined(SENSORLIB_ENABLE_BUS_TRACE)
+    const SensorBusStats_t &s = qmi.getBusStats();
+    CHECK(s.errors == 0 && s.transfers[SENSORLIB_BUS_READ] > 0);
+    qmi.dumpBusStats();
+    qmi.dumpBusTrace();
+#endif
+}
+
+static void runQMC6310(const char *recording)
+{
+    printf("QMC6310\n");
+    int samples = simMag.field.loadCsv(recording);
+    printf("  %d samples from %s\n", samples, recording);
+    CHECK(samples > 0);
+
+    CHECK(qmc.begin(QMC6310_SLAVE_ADDRESS, SensorSimBus::readCallback, SensorSimBus::transmitCallback));
+    CHECK(qmc.configMagnetometer(SensorQMC6310::MODE_CONTINUOUS, SensorQMC6310::RANGE_8G,
+                                 SensorQMC6310::DATARATE_200HZ, SensorQMC6310::OSR_1,
+                                 SensorQMC6310::DSR_1) == DEV_WIRE_NONE);
+
+    // Recorded times are absolute, repeat the turn for as long as the run goes
+    simMag.field.setLoop(true);
+    float last = -1;
+    for (int i = 0; i < 8; ++i) {
+        delay(250);
+        Polar p;
+        if (qmc.readPolar(p)) {
+            printf("  heading %6.1f deg  strength %.1f\n", p.polar, p.uT);
+            last = p.polar;
+        }
+    }
+    CHECK(last >= 0);
+    CHECK(qmc.getWriteAllocations() == 0);
+
+    // Nothing answers there
+    SensorQMC6310 missing;
+    CHECK(!missing.begin(0x2C, SensorSimBus::readCallback, SensorSimBus::writeCallback));
+}
+
+static void runBMA423()
+{
+    printf("BMA423\n");
+    simAccel.setTemperature(27);
+    CHECK(bma.begin(BMA423_SLAVE_ADDRESS, SensorSimBus::readCallback, SensorSimBus::transmitCallback));
+    CHECK(simAccel.initialized());
+    CHECK(bma.configAccelerometer(SensorBMA423::RANGE_2G, SensorBMA423::ODR_100HZ));
+    bma.enableAccelerometer();
+    delay(20);
+
+    int16_t x = 0, y = 0, z = 0;
+    CHECK(bma.getAccelerometer(x, y, z));
+    printf("  acc %d %d %d counts, %.1f C\n", x, y, z, bma.getTemperature(SensorBMA423::TEMP_DEG));
+    CHECK(z == 1024);
+    CHECK(near(bma.getTemperature(SensorBMA423::TEMP_DEG), 27.0f, 0.5f));
+
+    simAccel.setSteps(1234);
+    CHECK(bma.getPedometerCounter() == 1234);
+    bma.resetPedometer();
+    CHECK(bma.getPedometerCounter() == 0);
+    // The config upload and the feature writes fit the write buffer too
+    CHECK(bma.getWriteAllocations() == 0);
+}
+
+static void runPCF8563()
+{
+    printf("PCF8563\n");
+    CHECK(rtc.begin(PCF8563_SLAVE_ADDRESS, SensorSimBus::readCallback, SensorSimBus::writeCallback));
+    CHECK(!rtc.getDateTime().available);
+
+    rtc.setDateTime(2026, 10, 18, 23, 59, 50);
+    rtc.setAlarmByMinutes(0);
+    rtc.enableAlarm();
+    delay(11000);
+
+    RTC_DateTime now = rtc.getDateTime();
+    printf("  %04u-%02u-%02u %02u:%02u:%02u alarm %s\n", now.year, now.month, now.day,
+           now.hour, now.minute, now.second, rtc.isAlarmActive() ? "active" : "idle");
+    CHECK(now.available && now.year == 2026 && now.month == 10 && now.day == 19);
+    CHECK(now.hour == 0 && now.minute == 0 && now.second == 1);
+    CHECK(rtc.isAlarmActive() && !simRtc.interruptLevel());
+    rtc.resetAlarm();
+    CHECK(simRtc.interruptLevel());
+}
+
+static void runXL9555()
+{
+    printf("XL9555\n");
+    CHECK(io.begin(XL9555_SLAVE_ADDRESS0, SensorSimBus::readCallback, SensorSimBus::writeCallback));
+    io.pinMode(ExtensionIOXL9555::IO8, OUTPUT);
+    io.digitalWrite(ExtensionIOXL9555::IO8, LOW);
+    CHECK(!simExpander.getPin(8));
+    io.digitalWrite(ExtensionIOXL9555::IO8, HIGH);
+    CHECK(simExpander.getPin(8));
+
+    io.pinMode(ExtensionIOXL9555::IO0, INPUT);
+    simExpander.setInput(0, false);
+    CHECK(!simExpander.interruptLevel());
+    CHECK(io.digitalRead(ExtensionIOXL9555::IO0) == 0);
+    CHECK(simExpander.interruptLevel());
+    printf("  IO8 %d, IO0 %d\n", simExpander.getPin(8), io.digitalRead(ExtensionIOXL9555::IO0));
+}
+
+// Costs per value when a call reads \p values of them
+template <typename Call>
+static void benchmark(const char *name, Call call, int values = 1)
+{
+    SensorSimBus &bus = SensorSimBus::instance();
+    bus.resetStats();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+        call();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double n = (double)BENCHMARK_ROUNDS * values;
+    double host_ns = std::chrono::duration<double, std::nano>(end - start).count() / n;
+    const SensorSimStats_t &s = bus.stats();
+    printf("  %-28s %8.1f ns host %8.1f us bus %5.2f transfers %6.1f bytes\n", name, host_ns,
+           (double)s.bus_us / n, (double)(s.reads + s.writes) / n, (double)s.bytes / n);
+}
+
+static void runBenchmarks()
+{
+    printf("Benchmarks, %d rounds at 400 kHz\n", BENCHMARK_ROUNDS);
+    float x, y, z;
+    int16_t ix, iy, iz;
+    benchmark("QMI8658 getAccelerometer", [&]() {
+        qmi.getAccelerometer(x, y, z);
+    });
+    benchmark("QMI8658 accel + gyro", [&]() {
+        qmi.getAccelerometer(x, y, z);
+        qmi.getGyroscope(x, y, z);
+    });
+    benchmark("QMC6310 readData", [&]() {
+        qmc.readData();
+    });
+    benchmark("BMA423 getAccelerometer", [&]() {
+        bma.getAccelerometer(ix, iy, iz);
+    });
+    benchmark("PCF8563 getDateTime", [&]() {
+        rtc.getDateTime();
+    });
+    benchmark("XL9555 digitalRead", [&]() {
+        io.digitalRead(ExtensionIOXL9555::IO0);
+    });
+
+    // Per 12 bit value: two single byte reads, one pair read, three pairs at once
+    PairReader pairs;
+    uint16_t values[3];
+    CHECK(pairs.begin(QMI8658_L_SLAVE_ADDRESS, SensorSimBus::readCallback, SensorSimBus::writeCallback));
+    CHECK(pairs.readRegisterH8L4Burst(QMI8658_REG_AX_L, values, 3));
+    CHECK(values[0] == pairs.readRegisterH8L4(QMI8658_REG_AX_L, QMI8658_REG_AX_L + 1));
+    benchmark("H8L4 apart", [&]() {
+        pairs.readRegisterH8L4(QMI8658_REG_AX_L, QMI8658_REG_AX_L + 2);
+    });
+    benchmark("H8L4 adjacent", [&]() {
+        pairs.readRegisterH8L4(QMI8658_REG_AX_L, QMI8658_REG_AX_L + 1);
+    });
+    benchmark("H8L4 burst of 3", [&]() {
+        pairs.readRegisterH8L4Burst(QMI8658_REG_AX_L, values, 3);
+    }, 3);
+}
+
+int main(int argc, char **argv)
+{
+    SensorSimBus &bus = SensorSimBus::instance();
+    bus.attach(&simImu);
+    bus.attach(&simMag);
+    bus.attach(&simAccel);
+    bus.attach(&simRtc);
+    bus.attach(&simExpander);
+
+    runQMI8658();
+    runQMC6310(argc > 1 ? argv[1] : "magnetometer_turn.csv");
+    runBMA423();
+    runPCF8563();
+    runXL9555();
+    runBenchmarks();
+
+    printf("%s, %d failed checks, %.3f s simulated\n", failures ? "FAILED" : "OK", failures,
+           hostClockUs() / 1000000.0);
+    return failures;
+}
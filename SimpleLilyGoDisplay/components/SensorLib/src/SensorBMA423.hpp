@@ -182,20 +182,13 @@ public:
 
     bool enablePowerSave()
     {
-        uint8_t val;
-
-        val = readRegister(BMA4_POWER_CONF_ADDR);
-        val |= BMA4_ADVANCE_POWER_SAVE_MSK;
-        writeRegister(BMA4_POWER_CONF_ADDR, val);
+        writeField<AdvancedPowerSaveField>(1);
         return true;
     }
 
     bool disablePowerSave()
     {
-        uint8_t val;
-        val = readRegister(BMA4_POWER_CONF_ADDR);
-        val &= ~(BMA4_ADVANCE_POWER_SAVE_MSK);
-        writeRegister(BMA4_POWER_CONF_ADDR, val);
+        writeField<AdvancedPowerSaveField>(0);
         return true;
     }
 
@@ -212,19 +205,13 @@ public:
 
     bool enableAccelerometer()
     {
-        uint8_t val;
-        val = readRegister(BMA4_POWER_CTRL_ADDR);
-        val |= BMA4_ACCEL_ENABLE_MSK;
-        writeRegister(BMA4_POWER_CTRL_ADDR, val);
+        writeField<AccelEnableField>(1);
         return true;
     }
 
     bool disableAccelerometer()
     {
-        uint8_t val;
-        val = readRegister( BMA4_POWER_CTRL_ADDR);
-        val &= (~BMA4_ACCEL_ENABLE_MSK);
-        writeRegister(BMA4_POWER_CTRL_ADDR, val);
+        writeField<AccelEnableField>(0);
         return true;
     }
 
@@ -233,7 +220,6 @@ public:
                              PerformanceMode perfMode = PERF_CONTINUOUS_MODE)
 
     {
-        uint8_t buffer[2] = {0, 0};
         if (perfMode == PERF_CONTINUOUS_MODE) {
             if (bw > BW_NORMAL_AVG4) {
                 return false;
@@ -249,17 +235,12 @@ public:
             return false;
         }
 
-        buffer[0] = odr & 0x0F;
-        buffer[0] |= (uint8_t)(bw << 4);
-        buffer[0] |= (uint8_t)(perfMode << 7);
-        buffer[1] = range & 0x03;
-
         /* Burst write is not possible in
         suspend mode hence individual write is
         used with delay of 1 ms */
-        writeRegister(BMA4_ACCEL_CONFIG_ADDR, buffer[0]);
+        modifyFields<AccelOdrField, AccelBandwidthField, AccelPerfModeField>(odr, bw, perfMode);
         delay(2);
-        writeRegister(BMA4_ACCEL_CONFIG_ADDR + 1, buffer[1]);
+        writeField<AccelRangeField>(range);
         return true;
     }
 
@@ -417,10 +398,10 @@ public:
         int rslt;
         uint8_t buffer[BMA423_FEATURE_SIZE] = {0};
         /* Step detector enable bit pos. is 1 byte ahead of the base address */
-        uint8_t index = BMA423_STEP_CNTR_OFFSET + 1;
+        uint8_t index = StepDetectorEnableField::reg;
         rslt = readRegister(BMA4_FEATURE_CONFIG_ADDR, buffer, BMA423_FEATURE_SIZE);
         if (rslt != DEV_WIRE_ERR) {
-            buffer[index] = ((buffer[index] & ~0x08) | ((enable << 3) & 0x08));
+            buffer[index] = StepDetectorEnableField::update(buffer[index], enable);
             rslt = writeRegister(BMA4_FEATURE_CONFIG_ADDR, buffer, BMA423_FEATURE_SIZE);
         }
         return rslt != DEV_WIRE_ERR;
@@ -838,6 +819,20 @@ private:
     uint8_t int_line;
 
 protected:
+    /*
+     * Register fields, see SensorRegField.hpp
+     */
+    typedef RegField<BMA4_ACCEL_CONFIG_ADDR, 0, 4> AccelOdrField;
+    typedef RegField<BMA4_ACCEL_CONFIG_ADDR, 4, 3> AccelBandwidthField;
+    typedef RegField<BMA4_ACCEL_CONFIG_ADDR, 7, 1> AccelPerfModeField;
+    // Reserved bits of ACC_RANGE read back as 0
+    typedef RegField<BMA4_ACCEL_CONFIG_ADDR + 1, 0, 2, REG_WO> AccelRangeField;
+
+    typedef RegField<BMA4_POWER_CONF_ADDR, 0, 1> AdvancedPowerSaveField;
+    typedef RegField<BMA4_POWER_CTRL_ADDR, 2, 1> AccelEnableField;
+
+    // Byte offset in the feature area rather than a register
+    typedef RegField<BMA423_STEP_CNTR_OFFSET + 1, 3, 1> StepDetectorEnableField;
 
 
 };
@@ -206,22 +206,14 @@ public:
     int configMagnetometer(SensorMode mode, MagRange range, OutputRate odr,
                            OverSampleRatio osr, DownSampleRatio dsr)
     {
-        if (setMagRange(range) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-        if (writeRegister(QMC6310_REG_CMD1, 0xFC, mode) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-        if (writeRegister(QMC6310_REG_CMD1, 0xF3, (odr << 2)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-        if (writeRegister(QMC6310_REG_CMD1, 0xCF, (osr << 4)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-        if (writeRegister(QMC6310_REG_CMD1, 0x3F, (dsr << 6)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-        return DEV_WIRE_NONE;
+        // CMD1 fields are merged into a single write
+        beginBatch();
+        setMagRange(range);
+        writeRegister(QMC6310_REG_CMD1, 0xFC, mode);
+        writeRegister(QMC6310_REG_CMD1, 0xF3, (odr << 2));
+        writeRegister(QMC6310_REG_CMD1, 0xCF, (osr << 4));
+        writeRegister(QMC6310_REG_CMD1, 0x3F, (dsr << 6));
+        return submitBatch() == DEV_WIRE_NONE ? DEV_WIRE_NONE : DEV_WIRE_ERR;
     }
 
     int setMagRange(MagRange range)
@@ -392,6 +384,12 @@ private:
         return -1;
     }
 
+    // CMD2 holds the soft reset and self test bits
+    bool isVolatileRegisterImpl(int reg)
+    {
+        return !(reg == QMC6310_REG_CMD1 || reg == QMC6310_REG_SIGN);
+    }
+
 protected:
     int16_t raw[3];
     float mag[3];
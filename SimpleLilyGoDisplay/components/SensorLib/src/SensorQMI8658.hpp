@@ -212,6 +212,8 @@ public:
     {
         int val;
         writeRegister(QMI8658_REG_RESET, QMI8658_REG_RESET_DEFAULT);
+        // Every register is back to its default value
+        invalidateRegisterCache();
         // Maximum 15ms for the Reset process to be finished
         if (waitResult) {
             uint32_t start = millis();
@@ -276,10 +278,10 @@ public:
     {
         switch (pin) {
         case IntPin1:
-            enable ? setRegisterBit(QMI8658_REG_CTRL1, 3) : clrRegisterBit(QMI8658_REG_CTRL1, 3);
+            writeField<Int1EnableField>(enable);
             break;
         case IntPin2:
-            enable ? setRegisterBit(QMI8658_REG_CTRL1, 4) : clrRegisterBit(QMI8658_REG_CTRL1, 4);
+            writeField<Int2EnableField>(enable);
             break;
         default:
             break;
@@ -294,8 +296,7 @@ public:
 
     void enableDataReadyINT(bool enable = true)
     {
-        enable ? clrRegisterBit(QMI8658_REG_CTRL7, 5) :
-        setRegisterBit(QMI8658_REG_CTRL7, 5);
+        writeField<DataReadyDisableField>(!enable);
     }
 
     /**
@@ -313,14 +314,17 @@ public:
     {
         bool en = isEnableAccelerometer();
 
+        beginBatch();
+
         if (en) {
             disableAccelerometer();
         }
 
-        //setAccelRange
-        if (writeRegister(QMI8658_REG_CTRL2, 0x8F, (range << 4)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
+        // Range, output data rate and self test share CTRL2
+        modifyFields<AccelSelfTestField, AccelRangeField, AccelOdrField>(selfTest, range, odr);
+
+        // Low pass filter and its mode
+        modifyFields<AccelLpfEnableField, AccelLpfModeField>(lpf, lpfOdr);
 
         switch (range) {
         // Possible accelerometer scales (and their register bit settings) are:
@@ -333,27 +337,11 @@ public:
         case ACC_RANGE_16G: accelScales = 16.0 / 32768.0; break;
         }
 
-        // setAccelOutputDataRate
-        if (writeRegister(QMI8658_REG_CTRL2, 0xF0, odr) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-
-        // setAccelLowPassFitter
-        lpf ? setRegisterBit(QMI8658_REG_CTRL5, 0) : clrRegisterBit(QMI8658_REG_CTRL5, 0);
-
-        // setAccelLowPassFitterOdr
-        if (writeRegister(QMI8658_REG_CTRL5, QMI8658_ACCEL_LPF_MASK,  (lpfOdr << 1)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-
-        // setAccelSelfTest
-        selfTest ? setRegisterBit(QMI8658_REG_CTRL2, 7) : clrRegisterBit(QMI8658_REG_CTRL2, 7);
-
         if (en) {
             enableAccelerometer();
         }
 
-        return DEV_WIRE_NONE;
+        return submitBatch() == DEV_WIRE_NONE ? DEV_WIRE_NONE : DEV_WIRE_ERR;
     }
 
     /**
@@ -371,14 +359,17 @@ public:
     {
         bool en = isEnableGyroscope();
 
+        beginBatch();
+
         if (en) {
             disableGyroscope();
         }
 
-        // setGyroRange
-        if (writeRegister(QMI8658_REG_CTRL3, 0x8F, (range << 4)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
+        // Range, output data rate and self test share CTRL3
+        modifyFields<GyroSelfTestField, GyroRangeField, GyroOdrField>(selfTest, range, odr);
+
+        // Low pass filter and its mode
+        modifyFields<GyroLpfEnableField, GyroLpfModeField>(lpf, lpfOdr);
 
         switch (range) {
         // Possible gyro scales (and their register bit settings) are:
@@ -394,29 +385,11 @@ public:
         case GYR_RANGE_1024DPS: gyroScales = 1024.0 / 32768.0; break;
         }
 
-        // setGyroOutputDataRate
-        if (writeRegister(QMI8658_REG_CTRL3, 0xF0, odr) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-
-        // setGyroLowPassFitter
-        lpf ? setRegisterBit(QMI8658_REG_CTRL5, 4) : clrRegisterBit(QMI8658_REG_CTRL5, 4);
-
-
-        // setGyroLowPassFitterOdr
-        if (writeRegister(QMI8658_REG_CTRL5, QMI8658_GYRO_LPF_MASK,  (lpfOdr << 5)) != DEV_WIRE_NONE) {
-            return DEV_WIRE_ERR;
-        }
-
-        // setGyroSelfTest
-        selfTest ? setRegisterBit(QMI8658_REG_CTRL3, 7) : clrRegisterBit(QMI8658_REG_CTRL3, 7);
-
-
         if (en) {
             enableGyroscope();
         }
 
-        return DEV_WIRE_NONE;
+        return submitBatch() == DEV_WIRE_NONE ? DEV_WIRE_NONE : DEV_WIRE_ERR;
     }
 
     /**
@@ -494,7 +467,7 @@ public:
             return false;
         }
         if (!readFromFifo(buffer, bytes)) {
-            delete buffer;
+            delete[] buffer;
             return false;
         }
 
@@ -519,7 +492,7 @@ public:
             }
             counter++;
         }
-        delete buffer;
+        delete[] buffer;
         return true;
     }
 
@@ -592,37 +565,37 @@ public:
     bool enableAccelerometer()
     {
         accelEn = true;
-        return setRegisterBit(QMI8658_REG_CTRL7, 0) == DEV_WIRE_NONE;
+        return writeField<AccelEnableField>(1) == DEV_WIRE_NONE;
     }
 
     bool disableAccelerometer()
     {
         accelEn = false;
-        return clrRegisterBit(QMI8658_REG_CTRL7, 0) == DEV_WIRE_NONE;
+        return writeField<AccelEnableField>(0) == DEV_WIRE_NONE;
     }
 
     bool isEnableAccelerometer()
     {
-        accelEn = getRegisterBit(QMI8658_REG_CTRL7, 0);
+        accelEn = readField<AccelEnableField>() == 1;
         return accelEn;
     }
 
     bool isEnableGyroscope()
     {
-        gyroEn = getRegisterBit(QMI8658_REG_CTRL7, 1);
+        gyroEn = readField<GyroEnableField>() == 1;
         return gyroEn;
     }
 
     bool enableGyroscope()
     {
         gyroEn = true;
-        return setRegisterBit(QMI8658_REG_CTRL7, 1) == DEV_WIRE_NONE;
+        return writeField<GyroEnableField>(1) == DEV_WIRE_NONE;
     }
 
     bool disableGyroscope()
     {
         gyroEn = false;
-        return clrRegisterBit(QMI8658_REG_CTRL7, 1) == DEV_WIRE_NONE;
+        return writeField<GyroEnableField>(0) == DEV_WIRE_NONE;
     }
 
     bool getAccelRaw(int16_t *rawBuffer)
@@ -841,14 +814,17 @@ public:
             disableAccelerometer();
         }
 
+        // The CALx parameters go out as one write before each command
+        beginBatch();
+
         writeRegister(QMI8658_REG_CAL1_L, ped_sample_cnt & 0xFF);
         writeRegister(QMI8658_REG_CAL1_H, (ped_sample_cnt >> 8) & 0xFF);
         writeRegister(QMI8658_REG_CAL2_L, ped_fix_peak2peak & 0xFF);
         writeRegister(QMI8658_REG_CAL2_H, (ped_fix_peak2peak >> 8) & 0xFF);
         writeRegister(QMI8658_REG_CAL3_L, ped_fix_peak & 0xFF);
         writeRegister(QMI8658_REG_CAL3_H, (ped_fix_peak >> 8) & 0xFF);
-        writeRegister(QMI8658_REG_CAL4_H, 0x01);
         writeRegister(QMI8658_REG_CAL4_L, 0x02);
+        writeRegister(QMI8658_REG_CAL4_H, 0x01);
 
         writeCommand(CTRL_CMD_CONFIGURE_PEDOMETER);
 
@@ -858,11 +834,13 @@ public:
         writeRegister(QMI8658_REG_CAL2_H, ped_time_cnt_entry);
         writeRegister(QMI8658_REG_CAL3_L, ped_fix_precision);
         writeRegister(QMI8658_REG_CAL3_H, ped_sig_count);
-        writeRegister(QMI8658_REG_CAL4_H, 0x02);
         writeRegister(QMI8658_REG_CAL4_L, 0x02);
+        writeRegister(QMI8658_REG_CAL4_H, 0x02);
 
         writeCommand(CTRL_CMD_CONFIGURE_PEDOMETER);
 
+        int ret = submitBatch();
+
         if (enGyro) {
             enableGyroscope();
         }
@@ -870,7 +848,7 @@ public:
         if (enAccel) {
             enableAccelerometer();
         }
-        return 0;
+        return ret;
     }
 
     uint32_t getPedometerCounter()
@@ -959,6 +937,9 @@ public:
         if (enAccel) {
             disableAccelerometer();
         }
+
+        beginBatch();
+
         writeRegister(QMI8658_REG_CAL1_L, peakWindow);
         writeRegister(QMI8658_REG_CAL1_H, priority);
         writeRegister(QMI8658_REG_CAL2_L, tapWindow & 0xFF);
@@ -981,6 +962,8 @@ public:
 
         writeCommand(CTRL_CMD_CONFIGURE_TAP);
 
+        int ret = submitBatch();
+
         if (enGyro) {
             enableGyroscope();
         }
@@ -989,7 +972,7 @@ public:
             enableAccelerometer();
         }
 
-        return 0;
+        return ret;
     }
 
     int enableTap()
@@ -1077,6 +1060,9 @@ public:
         if (enAccel) {
             disableAccelerometer();
         }
+
+        beginBatch();
+
         writeRegister(QMI8658_REG_CAL1_L, AnyMotionXThr);
         writeRegister(QMI8658_REG_CAL1_H, AnyMotionYThr);
         writeRegister(QMI8658_REG_CAL2_L, AnyMotionZThr);
@@ -1099,6 +1085,8 @@ public:
 
         writeCommand(CTRL_CMD_CONFIGURE_MOTION);
 
+        int ret = submitBatch();
+
         if (enGyro) {
             enableGyroscope();
         }
@@ -1106,7 +1094,7 @@ public:
         if (enAccel) {
             enableAccelerometer();
         }
-        return 0;
+        return ret;
     }
 
     int enableMotionDetect()
@@ -1253,21 +1241,21 @@ public:
         // Indicates CTRL9 Command was done, as part of CTRL9 protocol
         // 0: Not Completed
         // 1: Done
-        if (status[0] & 0x80) {
+        if (CmdDoneField::decode(status[0])) {
             result |= STATUS_INT_CTRL9_CMD_DONE;
         }
         // If syncSmpl (CTRL7.bit7) = 1:
         //      0: Sensor Data is not locked.
         //      1: Sensor Data is locked.
         // If syncSmpl = 0, this bit shows the same value of INT1 level
-        if (status[0] & 0x02) {
+        if (LockedField::decode(status[0])) {
             result |= STATUS_INT_LOCKED;
         }
         // If syncSmpl (CTRL7.bit7) = 1:
         //      0: Sensor Data is not available
         //      1: Sensor Data is available for reading
         // If syncSmpl = 0, this bit shows the same value of INT2 level
-        if (status[0] & 0x01) {
+        if (AvailField::decode(status[0])) {
             result |= STATUS_INT_AVAIL;
             // if (eventGyroDataReady)eventGyroDataReady();
             // if (eventAccelDataReady)eventAccelDataReady();
@@ -1284,7 +1272,7 @@ public:
             // Gyroscope new data available
             // 0: No updates since last read.
             // 1: New data available
-            if (status[1] & 0x02) {
+            if (GyroDataReadyField::decode(status[1])) {
                 result |= STATUS0_GDATA_REDAY;
                 if (eventGyroDataReady)eventGyroDataReady();
                 __gDataReady = true;
@@ -1292,7 +1280,7 @@ public:
             // Accelerometer new data available
             // 0: No updates since last read.
             // 1: New data available.
-            if (status[1] & 0x01) {
+            if (AccelDataReadyField::decode(status[1])) {
                 result |= STATUS0_ADATA_REDAY;
                 if (eventAccelDataReady)eventAccelDataReady();
                 __aDataReady = true;
@@ -1303,42 +1291,42 @@ public:
         // Significant Motion
         // 0: No Significant-Motion was detected
         // 1: Significant-Motion was detected
-        if (status[2] & 0x80) {
+        if (SigMotionField::decode(status[2])) {
             result |= STATUS1_SIGNI_MOTION;
             if (eventSignificantMotion)eventSignificantMotion();
         }
         // No Motion
         // 0: No No-Motion was detected
         // 1: No-Motion was detected
-        if (status[2] & 0x40) {
+        if (NoMotionField::decode(status[2])) {
             result |= STATUS1_NO_MOTION;
             if (eventNoMotionEvent)eventNoMotionEvent();
         }
         // Any Motion
         // 0: No Any-Motion was detected
         // 1: Any-Motion was detected
-        if (status[2] & 0x20) {
+        if (AnyMotionField::decode(status[2])) {
             result |= STATUS1_ANY_MOTION;
             if (eventAnyMotionEvent)eventAnyMotionEvent();
         }
         // Pedometer
         // 0: No step was detected
         // 1: step was detected
-        if (status[2] & 0x10) {
+        if (PedometerField::decode(status[2])) {
             result |= STATUS1_PEDOME_MOTION;
             if (eventPedometerEvent)eventPedometerEvent();
         }
         // WoM
         // 0: No WoM was detected
         // 1: WoM was detected
-        if (status[2] & 0x04) {
+        if (WomField::decode(status[2])) {
             result |= STATUS1_WOM_MOTION;
             if (eventWomEvent)eventWomEvent();
         }
         // TAP
         // 0: No Tap was detected
         // 1: Tap was detected
-        if (status[2] & 0x02) {
+        if (TapField::decode(status[2])) {
             result |= STATUS1_TAP_MOTION;
             if (eventTagEvent)eventTagEvent();
         }
@@ -1447,6 +1435,42 @@ private:
     }
 
 protected:
+    /*
+     * Register fields, see SensorRegField.hpp
+     */
+    typedef RegField<QMI8658_REG_CTRL1, 3, 1> Int1EnableField;
+    typedef RegField<QMI8658_REG_CTRL1, 4, 1> Int2EnableField;
+
+    typedef RegField<QMI8658_REG_CTRL2, 0, 4> AccelOdrField;
+    typedef RegField<QMI8658_REG_CTRL2, 4, 3> AccelRangeField;
+    typedef RegField<QMI8658_REG_CTRL2, 7, 1> AccelSelfTestField;
+
+    typedef RegField<QMI8658_REG_CTRL3, 0, 4> GyroOdrField;
+    typedef RegField<QMI8658_REG_CTRL3, 4, 3> GyroRangeField;
+    typedef RegField<QMI8658_REG_CTRL3, 7, 1> GyroSelfTestField;
+
+    typedef RegField<QMI8658_REG_CTRL5, 0, 1> AccelLpfEnableField;
+    typedef RegField<QMI8658_REG_CTRL5, 1, 2> AccelLpfModeField;
+    typedef RegField<QMI8658_REG_CTRL5, 4, 1> GyroLpfEnableField;
+    typedef RegField<QMI8658_REG_CTRL5, 5, 2> GyroLpfModeField;
+
+    typedef RegField<QMI8658_REG_CTRL7, 0, 1> AccelEnableField;
+    typedef RegField<QMI8658_REG_CTRL7, 1, 1> GyroEnableField;
+    typedef RegField<QMI8658_REG_CTRL7, 5, 1> DataReadyDisableField;
+
+    typedef RegField<QMI8658_REG_STATUSINT, 0, 1, REG_RO> AvailField;
+    typedef RegField<QMI8658_REG_STATUSINT, 1, 1, REG_RO> LockedField;
+    typedef RegField<QMI8658_REG_STATUSINT, 7, 1, REG_RO> CmdDoneField;
+
+    typedef RegField<QMI8658_REG_STATUS0, 0, 1, REG_RO> AccelDataReadyField;
+    typedef RegField<QMI8658_REG_STATUS0, 1, 1, REG_RO> GyroDataReadyField;
+
+    typedef RegField<QMI8658_REG_STATUS1, 1, 1, REG_RO> TapField;
+    typedef RegField<QMI8658_REG_STATUS1, 2, 1, REG_RO> WomField;
+    typedef RegField<QMI8658_REG_STATUS1, 4, 1, REG_RO> PedometerField;
+    typedef RegField<QMI8658_REG_STATUS1, 5, 1, REG_RO> AnyMotionField;
+    typedef RegField<QMI8658_REG_STATUS1, 6, 1, REG_RO> NoMotionField;
+    typedef RegField<QMI8658_REG_STATUS1, 7, 1, REG_RO> SigMotionField;
 
     bool initImpl()
     {
@@ -1498,6 +1522,14 @@ protected:
         return 0x80;
     }
 
+    // Only the configuration registers keep what the host wrote, CTRL9 and
+    // FIFOCTRL take part in handshakes with the chip
+    bool isVolatileRegisterImpl(int reg)
+    {
+        return !((reg >= QMI8658_REG_CTRL1 && reg <= QMI8658_REG_CTRL8) ||
+                 reg == QMI8658_REG_FIFOWMKTH);
+    }
+
 };
 
 
@@ -0,0 +1,119 @@
+/**
+ * @file      SensorRegField.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * Compile time descriptors of the bit fields in an 8 bit register. A driver
+ * names each field once,
+ *
+ *      typedef RegField<QMI8658_REG_CTRL2, 4, 3> AccelRange;
+ *
+ * and SensorCommon::readField<>(), writeField<>() and modifyFields<>() work
+ * out the mask and shift. Everything is constexpr, a field access costs the
+ * same as the hand written mask and shift.
+ */
+#pragma once
+
+#include <stdint.h>
+
+enum SensorRegAccess {
+    REG_RW,
+    REG_RO,
+    // Reads do not return what was written, e.g. command registers. The
+    // other bits of the register are written as 0.
+    REG_WO,
+};
+
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access = REG_RW>
+struct RegField {
+    static_assert(Width >= 1 && Offset + Width <= 8, "RegField must fit in an 8 bit register");
+
+    static constexpr uint8_t reg = Reg;
+    static constexpr uint8_t offset = Offset;
+    static constexpr uint8_t width = Width;
+    static constexpr uint8_t mask = (uint8_t)(((1U << Width) - 1) << Offset);
+    static constexpr SensorRegAccess access = Access;
+
+    // Field value from the register value
+    static constexpr uint8_t decode(uint8_t regval)
+    {
+        return (regval & mask) >> Offset;
+    }
+
+    // Field value shifted into place, extra bits dropped
+    static constexpr uint8_t encode(uint8_t value)
+    {
+        return (uint8_t)(value << Offset) & mask;
+    }
+
+    // Register value with the field replaced, the other bits kept. Also works
+    // on a byte of a buffer, e.g. the BMA423 feature area.
+    static constexpr uint8_t update(uint8_t regval, uint8_t value)
+    {
+        return (uint8_t)((regval & ~mask) | encode(value));
+    }
+};
+
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access>
+constexpr uint8_t RegField<Reg, Offset, Width, Access>::reg;
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access>
+constexpr uint8_t RegField<Reg, Offset, Width, Access>::offset;
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access>
+constexpr uint8_t RegField<Reg, Offset, Width, Access>::width;
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access>
+constexpr uint8_t RegField<Reg, Offset, Width, Access>::mask;
+template <uint8_t Reg, uint8_t Offset, uint8_t Width, SensorRegAccess Access>
+constexpr SensorRegAccess RegField<Reg, Offset, Width, Access>::access;
+
+/*
+ * Helpers of modifyFields<>(), folding over a list of fields
+ */
+template <class Field>
+constexpr uint8_t regFieldMask()
+{
+    return Field::mask;
+}
+
+template <class Field, class Next, class... Rest>
+constexpr uint8_t regFieldMask()
+{
+    return Field::mask | regFieldMask<Next, Rest...>();
+}
+
+// All fields in the same register and none of them overlapping
+template <class Field>
+constexpr bool regFieldsDisjoint()
+{
+    return true;
+}
+
+template <class Field, class Next, class... Rest>
+constexpr bool regFieldsDisjoint()
+{
+    return Field::reg == Next::reg && !(Field::mask & regFieldMask<Next, Rest...>()) &&
+           regFieldsDisjoint<Next, Rest...>();
+}
+
+template <class Field>
+constexpr bool regFieldsWritable()
+{
+    return Field::access != REG_RO;
+}
+
+template <class Field, class Next, class... Rest>
+constexpr bool regFieldsWritable()
+{
+    return Field::access != REG_RO && regFieldsWritable<Next, Rest...>();
+}
+
+template <class Field, typename T>
+inline uint8_t regFieldBits(T value)
+{
+    return Field::encode((uint8_t)value);
+}
+
+template <class Field, class Next, class... Rest, typename T, typename... Values>
+inline uint8_t regFieldBits(T value, Values... rest)
+{
+    return Field::encode((uint8_t)value) | regFieldBits<Next, Rest...>(rest...);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file      host_platform.h
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * Arduino style helpers for building SensorLib on a desktop host, mostly to
+ * run the drivers against the register models in simulator/. Time is virtual:
+ * it only moves when a driver waits or a simulated transfer takes bus time,
+ * so a run is repeatable and never sleeps.
+ */
+#pragma once
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifndef INPUT
+#define INPUT                 (0x0)
+#endif
+
+#ifndef OUTPUT
+#define OUTPUT                (0x1)
+#endif
+
+#ifndef RISING
+#define RISING                (0x01)
+#endif
+
+#ifndef FALLING
+#define FALLING               (0x02)
+#endif
+
+#ifndef LOW
+#define LOW 0
+#endif
+
+#ifndef HIGH
+#define HIGH 1
+#endif
+
+#ifndef PI
+#define PI                    (3.1415926535897932384626433832795)
+#endif
+
+#define SENSORLIB_HOST_GPIO_NUM     64
+
+// Called whenever the virtual clock moves, with the new time in microseconds
+typedef void (*host_clock_fptr_t)(uint64_t now_us);
+
+inline uint64_t &hostClockUs()
+{
+    static uint64_t now_us = 0;
+    return now_us;
+}
+
+inline host_clock_fptr_t &hostClockHook()
+{
+    static host_clock_fptr_t hook = NULL;
+    return hook;
+}
+
+inline void hostAdvanceUs(uint64_t us)
+{
+    hostClockUs() += us;
+    if (hostClockHook()) {
+        hostClockHook()(hostClockUs());
+    }
+}
+
+inline uint8_t *hostGpioLevels()
+{
+    static uint8_t levels[SENSORLIB_HOST_GPIO_NUM];
+    return levels;
+}
+
+inline void pinMode(uint32_t gpio, uint8_t mode)
+{
+    (void)gpio;
+    (void)mode;
+}
+
+inline void digitalWrite(uint32_t gpio, uint8_t level)
+{
+    if (gpio < SENSORLIB_HOST_GPIO_NUM) {
+        hostGpioLevels()[gpio] = level ? HIGH : LOW;
+    }
+}
+
+inline int digitalRead(uint32_t gpio)
+{
+    return gpio < SENSORLIB_HOST_GPIO_NUM ? hostGpioLevels()[gpio] : LOW;
+}
+
+inline void delay(uint32_t ms)
+{
+    hostAdvanceUs((uint64_t)ms * 1000ULL);
+}
+
+inline void delayMicroseconds(uint32_t us)
+{
+    hostAdvanceUs(us);
+}
+
+inline uint32_t millis()
+{
+    return (uint32_t)(hostClockUs() / 1000ULL);
+}
+
+inline uint32_t micros()
+{
+    return (uint32_t)hostClockUs();
+}
+
+#endif
@@ -0,0 +1,433 @@
+/**
+ * @file      SensorSimulator.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * Register map simulator for running the drivers on a desktop host. A chip
+ * model holds the register file of one device and reacts to accesses the way
+ * the part does; the bus routes the custom interface callbacks of
+ * SensorCommon::begin(addr, read, write) to the model at that address and
+ * charges every transfer its wire time on the virtual clock of
+ * platform/host_platform.h. Build with -DSENSORLIB_HOST, see
+ * examples/SensorSimulator_Linux.
+ *
+ * Only models for devices with one byte register addresses can be attached,
+ * the callbacks carry nothing wider.
+ */
+#pragma once
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+#include "../SensorLib.h"
+#include <algorithm>
+#include <vector>
+
+#define SENSORSIM_MAX_CHIPS         8
+#define SENSORSIM_MAX_CHANNELS      8
+
+class SensorSimChip
+{
+public:
+    SensorSimChip(uint8_t addr) : __addr(addr)
+    {
+        memset(__regs, 0, sizeof(__regs));
+    }
+
+    virtual ~SensorSimChip() {}
+
+    uint8_t address() const
+    {
+        return __addr;
+    }
+
+    // A transfer addresses one register and moves len bytes from there on,
+    // nextRegister() says where the following byte goes
+    int read(uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        if (!__online) {
+            return DEV_WIRE_ERR;
+        }
+        startTransfer(reg, false);
+        for (uint8_t i = 0; i < len; ++i) {
+            buf[i] = readByte(reg);
+            reg = nextRegister(reg);
+        }
+        endTransfer(false);
+        return DEV_WIRE_NONE;
+    }
+
+    int write(uint8_t reg, const uint8_t *buf, uint8_t len)
+    {
+        if (!__online) {
+            return DEV_WIRE_ERR;
+        }
+        startTransfer(reg, true);
+        for (uint8_t i = 0; i < len; ++i) {
+            writeByte(reg, buf[i]);
+            reg = nextRegister(reg);
+        }
+        endTransfer(true);
+        return DEV_WIRE_NONE;
+    }
+
+    // Brings the model to the given time, called before every transfer and
+    // whenever the clock moves
+    virtual void step(uint64_t now_us)
+    {
+        (void)now_us;
+    }
+
+    // An offline chip NACKs its address, for testing the error paths
+    void setOnline(bool online)
+    {
+        __online = online;
+    }
+
+    // Register access that bypasses the behaviour of the model
+    uint8_t peek(uint8_t reg) const
+    {
+        return __regs[reg];
+    }
+
+    void poke(uint8_t reg, uint8_t val)
+    {
+        __regs[reg] = val;
+    }
+
+protected:
+    virtual void startTransfer(uint8_t reg, bool write)
+    {
+        (void)reg;
+        (void)write;
+    }
+
+    virtual void endTransfer(bool write)
+    {
+        (void)write;
+    }
+
+    virtual uint8_t readByte(uint8_t reg)
+    {
+        return __regs[reg];
+    }
+
+    virtual void writeByte(uint8_t reg, uint8_t val)
+    {
+        __regs[reg] = val;
+    }
+
+    virtual uint8_t nextRegister(uint8_t reg)
+    {
+        return reg + 1;
+    }
+
+    void putLE16(uint8_t reg, int16_t val)
+    {
+        __regs[reg] = (uint8_t)(val & 0xFF);
+        __regs[(uint8_t)(reg + 1)] = (uint8_t)((uint16_t)val >> 8);
+    }
+
+    static int16_t saturate(float val, bool *clipped = NULL)
+    {
+        float r = roundf(val);
+        if (r > 32767.0f || r < -32768.0f) {
+            if (clipped) {
+                *clipped = true;
+            }
+            return r > 0 ? 32767 : -32768;
+        }
+        return (int16_t)r;
+    }
+
+    uint8_t     __addr;
+    bool        __online = true;
+    uint8_t     __regs[256];
+};
+
+/*
+ * Input data of a model, one or more channels over time. Samples come from a
+ * generator function or from a recording; between recorded samples the last
+ * one holds.
+ */
+class SensorSimTrace
+{
+public:
+    typedef void (*generator_fptr_t)(uint64_t t_us, float *out, void *user_data);
+
+    SensorSimTrace(uint8_t channels = 3) : __channels(channels > SENSORSIM_MAX_CHANNELS ? SENSORSIM_MAX_CHANNELS : channels)
+    {
+        memset(__constant, 0, sizeof(__constant));
+    }
+
+    uint8_t channels() const
+    {
+        return __channels;
+    }
+
+    void setConstant(const float *values)
+    {
+        clear();
+        memcpy(__constant, values, __channels * sizeof(float));
+    }
+
+    void setGenerator(generator_fptr_t gen, void *user_data = NULL)
+    {
+        clear();
+        __generator = gen;
+        __user_data = user_data;
+    }
+
+    // Samples must come in time order
+    void add(uint64_t t_us, const float *values)
+    {
+        __generator = NULL;
+        __time.push_back(t_us);
+        __values.insert(__values.end(), values, values + __channels);
+    }
+
+    /*
+     * Lines of "t_us,v0,v1,..." with at least the channels of the trace,
+     * blank lines and lines starting with '#' are skipped.
+     * @retval samples loaded, -1 if the file does not open
+     */
+    int loadCsv(const char *path)
+    {
+        FILE *f = fopen(path, "r");
+        if (!f) {
+            return -1;
+        }
+        clear();
+        char line[256];
+        int count = 0;
+        while (fgets(line, sizeof(line), f)) {
+            char *p = line;
+            while (*p == ' ' || *p == '\t') {
+                p++;
+            }
+            if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') {
+                continue;
+            }
+            char *end;
+            uint64_t t = strtoull(p, &end, 10);
+            float values[SENSORSIM_MAX_CHANNELS];
+            uint8_t n = 0;
+            while (n < __channels && *end == ',') {
+                p = end + 1;
+                values[n] = strtof(p, &end);
+                if (end == p) {
+                    break;
+                }
+                n++;
+            }
+            if (n == __channels) {
+                add(t, values);
+                count++;
+            }
+        }
+        fclose(f);
+        return count;
+    }
+
+    // A recording starts over after its last sample
+    void setLoop(bool loop)
+    {
+        __loop = loop;
+    }
+
+    void sample(uint64_t t_us, float *out) const
+    {
+        if (__generator) {
+            __generator(t_us, out, __user_data);
+            return;
+        }
+        if (__time.empty()) {
+            memcpy(out, __constant, __channels * sizeof(float));
+            return;
+        }
+        uint64_t span = __time.back() + 1;
+        if (__loop && t_us >= span) {
+            t_us %= span;
+        }
+        // Last sample at or before t_us, the first one before that
+        size_t lo = 0, hi = __time.size();
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (__time[mid] <= t_us) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        memcpy(out, &__values[lo * __channels], __channels * sizeof(float));
+    }
+
+private:
+    void clear()
+    {
+        __generator = NULL;
+        __time.clear();
+        __values.clear();
+    }
+
+    uint8_t                 __channels;
+    float                   __constant[SENSORSIM_MAX_CHANNELS];
+    generator_fptr_t        __generator = NULL;
+    void                    *__user_data = NULL;
+    bool                    __loop = false;
+    std::vector<uint64_t>   __time;
+    std::vector<float>      __values;
+};
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t bytes;         // Data bytes, without address and register bytes
+    uint32_t nacks;
+    uint64_t bus_us;        // Wire time of all transfers
+} SensorSimStats_t;
+
+/*
+ * The one simulated I2C bus, its callbacks can be handed to any driver.
+ */
+class SensorSimBus
+{
+public:
+    static SensorSimBus &instance()
+    {
+        static SensorSimBus bus;
+        return bus;
+    }
+
+    bool attach(SensorSimChip *chip)
+    {
+        if (find(chip->address()) || __count >= SENSORSIM_MAX_CHIPS) {
+            return false;
+        }
+        __chips[__count++] = chip;
+        chip->step(hostClockUs());
+        return true;
+    }
+
+    void detach(SensorSimChip *chip)
+    {
+        for (uint8_t i = 0; i < __count; ++i) {
+            if (__chips[i] == chip) {
+                __chips[i] = __chips[--__count];
+                return;
+            }
+        }
+    }
+
+    void setClock(uint32_t hz)
+    {
+        __clock_hz = hz ? hz : 1;
+    }
+
+    // Time the host side adds to every transfer, driver and interrupt latency
+    void setTransferOverhead(uint32_t us)
+    {
+        __overhead_us = us;
+    }
+
+    const SensorSimStats_t &stats() const
+    {
+        return __stats;
+    }
+
+    void resetStats()
+    {
+        memset(&__stats, 0, sizeof(__stats));
+    }
+
+    static int readCallback(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint8_t len)
+    {
+        SensorSimBus &bus = instance();
+        // Address and register, then a repeated start and the address again
+        SensorSimChip *chip = bus.transfer(devAddr, 3 + len, 3);
+        if (!chip) {
+            return DEV_WIRE_ERR;
+        }
+        int ret = chip->read(regAddr, data, len);
+        bus.count(ret, &bus.__stats.reads, len);
+        return ret;
+    }
+
+    static int writeCallback(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint8_t len)
+    {
+        SensorSimBus &bus = instance();
+        SensorSimChip *chip = bus.transfer(devAddr, 2 + len, 2);
+        if (!chip) {
+            return DEV_WIRE_ERR;
+        }
+        int ret = chip->write(regAddr, data, len);
+        bus.count(ret, &bus.__stats.writes, len);
+        return ret;
+    }
+
+    // Same write as one transaction buffer, for begin() with a transmit
+    // callback: the driver assembles register address and data itself
+    static int transmitCallback(uint8_t devAddr, const uint8_t *data, size_t len)
+    {
+        if (len == 0 || len - 1 > UINT8_MAX) {
+            return DEV_WIRE_ERR;
+        }
+        return writeCallback(devAddr, data[0], (uint8_t *)data + 1, (uint8_t)(len - 1));
+    }
+
+private:
+    SensorSimBus()
+    {
+        memset(&__stats, 0, sizeof(__stats));
+        hostClockHook() = onClock;
+    }
+
+    static void onClock(uint64_t now_us)
+    {
+        SensorSimBus &bus = instance();
+        for (uint8_t i = 0; i < bus.__count; ++i) {
+            bus.__chips[i]->step(now_us);
+        }
+    }
+
+    SensorSimChip *find(uint8_t addr)
+    {
+        for (uint8_t i = 0; i < __count; ++i) {
+            if (__chips[i]->address() == addr) {
+                return __chips[i];
+            }
+        }
+        return NULL;
+    }
+
+    void count(int ret, uint32_t *transfers, uint8_t len)
+    {
+        if (ret != DEV_WIRE_NONE) {
+            __stats.nacks++;
+            return;
+        }
+        (*transfers)++;
+        __stats.bytes += len;
+    }
+
+    // Nine clocks per byte plus the start, repeated start and stop conditions
+    SensorSimChip *transfer(uint8_t addr, uint32_t bytes, uint32_t conditions)
+    {
+        SensorSimChip *chip = find(addr);
+        uint64_t bits = chip ? bytes * 9 + conditions : 9 + 2;
+        uint64_t us = (bits * 1000000ULL + __clock_hz - 1) / __clock_hz + __overhead_us;
+        __stats.bus_us += us;
+        hostAdvanceUs(us);
+        if (!chip) {
+            __stats.nacks++;
+        }
+        return chip;
+    }
+
+    SensorSimChip       *__chips[SENSORSIM_MAX_CHIPS];
+    uint8_t             __count = 0;
+    uint32_t            __clock_hz = 400000;
+    uint32_t            __overhead_us = 0;
+    SensorSimStats_t    __stats;
+};
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file      SimBMA423.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * BMA423 model: soft reset, the configuration upload through the feature
+ * port and INIT_CTRL, the 64 byte feature area afterwards, accelerometer
+ * sampling at the configured rate and range, temperature, step counter and
+ * interrupt status. The feature engine itself does not run, steps and
+ * interrupts are set from the test.
+ */
+#pragma once
+
+#include "SensorSimulator.hpp"
+#include "../REG/BMA423Constants.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+class SimBMA423 : public SensorSimChip
+{
+public:
+    SimBMA423(uint8_t addr = BMA423_SLAVE_ADDRESS) : SensorSimChip(addr), accel(3)
+    {
+        reset();
+        const float gravity[3] = {0, 0, 1.0f};
+        accel.setConstant(gravity);
+    }
+
+    void reset()
+    {
+        memset(__regs, 0, sizeof(__regs));
+        memset(__features, 0, sizeof(__features));
+        __uploaded.assign(BMA4_CONFIG_STREAM_SIZE, false);
+        __regs[BMA4_CHIP_ID_ADDR] = BMA423_CHIP_ID;
+        __regs[BMA4_ACCEL_CONFIG_ADDR] = 0xA8;
+        __regs[BMA4_ACCEL_CONFIG_ADDR + 1] = 0x01;
+        __regs[BMA4_POWER_CONF_ADDR] = 0x03;
+        setTemperature(__temperature);
+        setSteps(0);
+    }
+
+    // Acceleration in g
+    SensorSimTrace accel;
+
+    void setTemperature(float celsius)
+    {
+        __temperature = celsius;
+        __regs[BMA4_TEMPERATURE_ADDR] = (uint8_t)(int8_t)roundf(celsius - 23.0f);
+    }
+
+    void setSteps(uint32_t steps)
+    {
+        for (int i = 0; i < 4; ++i) {
+            __regs[BMA4_STEP_CNT_OUT_0_ADDR + i] = (uint8_t)(steps >> (i * 8));
+        }
+    }
+
+    // Feature interrupt bits in INT_STAT_0, data ready and errors in INT_STAT_1
+    void raiseInterrupt(uint16_t status)
+    {
+        __regs[BMA4_INT_STAT_0_ADDR] |= (uint8_t)status;
+        __regs[BMA4_INT_STAT_0_ADDR + 1] |= (uint8_t)(status >> 8);
+    }
+
+    bool initialized() const
+    {
+        return __regs[BMA4_INTERNAL_STAT] == BMA4_ASIC_INITIALIZED;
+    }
+
+    void step(uint64_t now_us)
+    {
+        __now = now_us;
+        if (!(__regs[BMA4_POWER_CTRL_ADDR] & BMA4_ACCEL_ENABLE_MSK)) {
+            return;
+        }
+        uint32_t period = samplePeriod();
+        if (now_us >= __next_us + period) {
+            __next_us += ((now_us - __next_us) / period) * period;
+        }
+        while (__next_us <= now_us) {
+            sample(__next_us);
+            __next_us += period;
+        }
+    }
+
+protected:
+    void startTransfer(uint8_t reg, bool write)
+    {
+        (void)reg;
+        (void)write;
+        __port_offset = 0;
+    }
+
+    void endTransfer(bool write)
+    {
+        // Step counter reset request in the feature area
+        uint8_t &ctrl = __features[BMA423_STEP_CNTR_OFFSET + 1];
+        if (write && (ctrl & 0x04)) {
+            ctrl &= ~0x04;
+            setSteps(0);
+        }
+    }
+
+    uint8_t readByte(uint8_t reg)
+    {
+        switch (reg) {
+        case BMA4_FEATURE_CONFIG_ADDR:
+            if (initialized()) {
+                return __features[__port_offset++ % BMA423_FEATURE_SIZE];
+            }
+            return 0;
+        case BMA4_INT_STAT_0_ADDR:
+        case BMA4_INT_STAT_0_ADDR + 1: {
+            uint8_t val = __regs[reg];
+            __regs[reg] = 0;
+            return val;
+        }
+        case BMA4_DATA_8_ADDR + 5:
+            // The last output byte releases data ready
+            __regs[STATUS_REG] &= ~0x80;
+            return __regs[reg];
+        default:
+            return __regs[reg];
+        }
+    }
+
+    void writeByte(uint8_t reg, uint8_t val)
+    {
+        switch (reg) {
+        case BMA423_RESET_REG:
+            if (val == 0xB6) {
+                reset();
+            }
+            break;
+        case BMA4_FEATURE_CONFIG_ADDR:
+            if (initialized()) {
+                __features[__port_offset++ % BMA423_FEATURE_SIZE] = val;
+            } else if (!(__regs[BMA4_POWER_CONF_ADDR] & BMA4_ADVANCE_POWER_SAVE_MSK)) {
+                // Bursts are lost in advanced power save, as on the part
+                uint32_t index = asicAddress() * 2 + __port_offset++;
+                if (index < __uploaded.size()) {
+                    __uploaded[index] = true;
+                }
+            }
+            break;
+        case BMA4_INIT_CTRL_ADDR:
+            __regs[reg] = val;
+            if (val == 0x01 && !initialized()) {
+                bool complete = std::find(__uploaded.begin(), __uploaded.end(), false) == __uploaded.end();
+                __regs[BMA4_INTERNAL_STAT] = complete ? BMA4_ASIC_INITIALIZED : 0x02;
+            }
+            break;
+        case BMA4_POWER_CTRL_ADDR:
+            if ((val & ~__regs[reg]) & BMA4_ACCEL_ENABLE_MSK) {
+                __next_us = __now + samplePeriod();
+            }
+            __regs[reg] = val;
+            break;
+        case BMA4_CHIP_ID_ADDR:
+        case BMA4_INTERNAL_STAT:
+            break;
+        default:
+            __regs[reg] = val;
+            break;
+        }
+    }
+
+    uint8_t nextRegister(uint8_t reg)
+    {
+        return reg == BMA4_FEATURE_CONFIG_ADDR ? reg : reg + 1;
+    }
+
+private:
+    static const uint8_t STATUS_REG = 0x03;
+
+    uint32_t asicAddress() const
+    {
+        return (__regs[BMA4_RESERVED_REG_5B_ADDR] & 0x0F) | ((uint32_t)__regs[BMA4_RESERVED_REG_5B_ADDR + 1] << 4);
+    }
+
+    // ODR code 8 is 100 Hz, every step doubles or halves it
+    uint32_t samplePeriod() const
+    {
+        int code = __regs[BMA4_ACCEL_CONFIG_ADDR] & 0x0F;
+        if (code < 1) {
+            code = 1;
+        }
+        return (uint32_t)(10000.0f / powf(2.0f, (float)(code - 8)));
+    }
+
+    void sample(uint64_t t_us)
+    {
+        float v[3];
+        accel.sample(t_us, v);
+        float lsb = 2048.0f / (float)(2 << (__regs[BMA4_ACCEL_CONFIG_ADDR + 1] & 0x03));
+        for (int i = 0; i < 3; ++i) {
+            // 12 bit counts, left aligned in the 16 bit output registers
+            float counts = roundf(v[i] * lsb);
+            counts = counts > 2047.0f ? 2047.0f : (counts < -2048.0f ? -2048.0f : counts);
+            putLE16(BMA4_DATA_8_ADDR + i * 2, (int16_t)((int16_t)counts * 16));
+        }
+        __regs[STATUS_REG] |= 0x80;
+        __regs[BMA4_INT_STAT_0_ADDR + 1] |= 0x80;
+    }
+
+    uint64_t            __now = 0;
+    uint64_t            __next_us = 0;
+    float               __temperature = 25.0f;
+    uint32_t            __port_offset = 0;
+    uint8_t             __features[BMA423_FEATURE_SIZE];
+    std::vector<bool>   __uploaded;
+};
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file      SimQMC6310.hpp
+ * @license   MIT
+ * @date      2026-10-18
+ *
+ * QMC6310 model: soft reset, suspend, normal, single and continuous modes at
+ * the configured output rate, range scaling with overflow and the data ready
+ * flag. The field trace is in the unit getX() returns, the range table of the
+ * driver converts it to counts.
+ */
+#pragma once
+
+#include "SensorSimulator.hpp"
+#include "../REG/QMC6310Constants.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && defined(SENSORLIB_HOST)
+
+class SimQMC6310 : public SensorSimChip
+{
+public:
+    SimQMC6310(uint8_t addr = QMC6310_SLAVE_ADDRESS) : SensorSimChip(addr), field(3)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        memset(__regs, 0, sizeof(__regs));
+        __regs[QMC6310_REG_CHIP_ID] = QMC6310_DEFAULT_ID;
+    }
+
+    SensorSimTrace field;
+
+    void step(uint64_t now_us)
+    {
+        __now = now_us;
+        uint8_t mode = __regs[QMC6310_REG_CMD1] & 0x03;
+        if (mode == 0) {
+            return;
+        }
+        if (mode == 2) {
+            // Single measurement, then back to suspend
+            if (__next_us <= now_us) {
+                sample(__next_us);
+                __regs[QMC6310_REG_CMD1] &= ~0x03;
+            }
+            return;
+        }
+        uint32_t period = samplePeriod();
+        if (now_us >= __next_us + period) {
+            __next_us += ((now_us - __next_us) / period) * period;
+        }
+        while (__next_us <= now_us) {
+            sample(__next_us);
+            __next_us += period;
+        }
+    }
+
+protected:
+    uint8_t readByte(uint8_t reg)
+    {
+        // Reading the last output byte clears the status
+        if (reg == QMC6310_REG_MSB_DZ) {
+            __regs[QMC6310_REG_STAT] = 0;
+        }
+        return __regs[reg];
+    }
+
+    void writeByte(uint8_t reg, uint8_t val)
+    {
+        switch (reg) {
+        case QMC6310_REG_CMD1:
+            if ((val & 0x03) != (__regs[reg] & 0x03)) {
+                __next_us = __now + ((val & 0x03) == 2 ? 1000 : samplePeriod(val));
+            }
+            __regs[reg] = val;
+            break;
+        case QMC6310_REG_CMD2:
+            if (val & 0x80) {
+                reset();
+            }
+            __regs[reg] = val;
+            break;
+        case QMC6310_REG_CHIP_ID:
+        case QMC6310_REG_STAT:
+            break;
+        default:
+            __regs[reg] = val;
+            break;
+        }
+    }
+
+private:
+    uint32_t samplePeriod(uint8_t cmd1) const
+    {
+        static const uint32_t hz[4] = {10, 50, 100, 200};
+        return 1000000UL / hz[(cmd1 >> 2) & 0x03];
+    }
+
+    uint32_t samplePeriod() const
+    {
+        return samplePeriod(__regs[QMC6310_REG_CMD1]);
+    }
+
+    void sample(uint64_t t_us)
+    {
+        static const float sensitivity[4] = {0.1f, 0.04f, 0.026f, 0.0066f};
+        float v[3];
+        bool clipped = false;
+        field.sample(t_us, v);
+        float scale = sensitivity[(__regs[QMC6310_REG_CMD2] >> 2) & 0x03];
+        for (int i = 0; i < 3; ++i) {
+            putLE16(QMC6310_REG_LSB_DX + i * 2, saturate(v[i] / scale, &clipped));
+        }
+        __regs[QMC6310_REG_STAT] = clipped ? 0x03 : 0x01;
+    }
+
+    uint64_t    __now = 0;
+    uint64_t    __next_us = 0;
+};
+
+#endif
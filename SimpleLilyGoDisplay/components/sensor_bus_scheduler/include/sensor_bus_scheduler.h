@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cyclic executive for the devices of one I2C (or SPI) bus.
+ *
+ * Every device registers its periodic reads as jobs. `sensor_bus_sched_start()`
+ * lays the jobs out over the hyperperiod, the least common multiple of the
+ * periods, split in minor frames of the greatest common divisor. Each job
+ * instance lands in the first frame at or after its release with room for its
+ * bus time, higher priority first, so the transfers of a frame run back to
+ * back and never overlap. A layout that misses a deadline is rejected.
+ *
+ * One task then runs the frames, woken by an esp_timer at every frame start,
+ * and records deadline misses, errors and the bus time actually used.
+ *
+ * @code
+ * static esp_err_t read_imu(void *ctx)
+ * {
+ *     SensorQMI8658 *imu = (SensorQMI8658 *)ctx;
+ *     float x, y, z;
+ *     return imu->getAccelerometer(x, y, z) ? ESP_OK : ESP_FAIL;
+ * }
+ *
+ * sensor_bus_job_config_t job = {
+ *     .name = "imu", .read = read_imu, .user_ctx = &qmi,
+ *     .period_us = 10000, .cost_us = 210,
+ * };
+ * sensor_bus_sched_add_job(sched, &job, NULL);
+ * @endcode
+ */
+typedef struct sensor_bus_sched_t *sensor_bus_sched_handle_t;
+
+/**
+ * @brief Bus transactions of one job, called from the scheduler task
+ *
+ * @return ESP_OK, anything else is counted as an error of the job
+ */
+typedef esp_err_t (*sensor_bus_job_fn_t)(void *user_ctx);
+
+typedef struct {
+    const char *name;               /*!< For the logs, may be NULL */
+    sensor_bus_job_fn_t read;       /*!< Transactions to run every period */
+    void *user_ctx;                 /*!< Passed to `read` */
+    uint32_t period_us;             /*!< Release period */
+    uint32_t deadline_us;           /*!< From the release to the end of `read`, 0 for the period */
+    uint32_t cost_us;               /*!< Worst case bus time of `read`, e.g. from the SensorLib bus trace */
+    uint8_t priority;               /*!< Higher goes first among the jobs released in a frame */
+} sensor_bus_job_config_t;
+
+typedef struct {
+    uint32_t minor_frame_us;        /*!< 0 for the greatest common divisor of the periods */
+    uint32_t max_frames;            /*!< Upper bound of hyperperiod / minor frame, 0 for 1000 */
+    uint8_t max_jobs;               /*!< 0 for 8 */
+    UBaseType_t task_priority;      /*!< 0 for configMAX_PRIORITIES - 2 */
+    uint32_t task_stack;            /*!< 0 for 4096 */
+    BaseType_t task_core;           /*!< Core number, 0 in a zeroed config, or tskNO_AFFINITY */
+} sensor_bus_sched_config_t;
+
+/**
+ * @brief Every field at its default and the task free to run on any core
+ */
+#define SENSOR_BUS_SCHED_CONFIG_DEFAULT()   \
+    {                                       \
+        .task_core = tskNO_AFFINITY,        \
+    }
+
+typedef struct {
+    uint32_t runs;
+    uint32_t errors;                /*!< `read` did not return ESP_OK */
+    uint32_t deadline_misses;       /*!< `read` ended after release + deadline */
+    uint32_t cost_overruns;         /*!< `read` took longer than cost_us */
+    uint32_t max_exec_us;           /*!< Longest `read` */
+    uint32_t max_response_us;       /*!< Longest time from release to the end of `read` */
+    uint32_t offset_us;             /*!< Start of the first instance in the hyperperiod */
+} sensor_bus_job_stats_t;
+
+typedef struct {
+    uint32_t minor_frame_us;
+    uint32_t hyperperiod_us;
+    uint32_t frames;                /*!< Minor frames in the hyperperiod */
+    uint32_t instances;             /*!< Job runs in the hyperperiod */
+    float planned_utilization;      /*!< Sum of cost / period, 0 to 1 */
+    float measured_utilization;     /*!< Time spent in `read` over the time running */
+    uint32_t frames_run;
+    uint32_t frames_skipped;        /*!< Frames the task started too late to run */
+    uint32_t deadline_misses;       /*!< All jobs */
+} sensor_bus_sched_stats_t;
+
+/**
+ * @brief Create a scheduler, it runs nothing until `sensor_bus_sched_start()`
+ *
+ * @param[in] config Scheduler configuration, NULL for SENSOR_BUS_SCHED_CONFIG_DEFAULT()
+ * @param[out] ret_sched Returned scheduler handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_NO_MEM        if out of memory
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_new(const sensor_bus_sched_config_t *config, sensor_bus_sched_handle_t *ret_sched);
+
+/**
+ * @brief Register a job, only while the scheduler is stopped
+ *
+ * @param[in] sched Scheduler handle
+ * @param[in] job_config Job configuration, copied
+ * @param[out] ret_job_id Index for `sensor_bus_sched_get_job_stats()`, may be NULL
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_ERR_INVALID_STATE if the scheduler is running
+ *          - ESP_ERR_NO_MEM        if max_jobs are registered
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_add_job(sensor_bus_sched_handle_t sched, const sensor_bus_job_config_t *job_config,
+                                   int *ret_job_id);
+
+/**
+ * @brief Build the schedule and start running it
+ *
+ * @param[in] sched Scheduler handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if a period is not a multiple of the minor frame
+ *          - ESP_ERR_INVALID_SIZE  if the hyperperiod has more than max_frames frames
+ *          - ESP_ERR_NOT_FOUND     if no layout meets every deadline, the log names the job
+ *          - ESP_ERR_INVALID_STATE if already running or without jobs
+ *          - ESP_ERR_NO_MEM        if out of memory
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_start(sensor_bus_sched_handle_t sched);
+
+/**
+ * @brief Stop after the frame in progress, jobs can be added again afterwards
+ *
+ * @param[in] sched Scheduler handle
+ * @return
+ *          - ESP_ERR_INVALID_STATE if not running
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_stop(sensor_bus_sched_handle_t sched);
+
+/**
+ * @brief Stop if needed and free the scheduler
+ *
+ * @param[in] sched Scheduler handle
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_del(sensor_bus_sched_handle_t sched);
+
+/**
+ * @brief Layout and totals since the last start
+ *
+ * @param[in] sched Scheduler handle
+ * @param[out] stats Statistics
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_get_stats(sensor_bus_sched_handle_t sched, sensor_bus_sched_stats_t *stats);
+
+/**
+ * @brief Counters of one job since the last start
+ *
+ * @param[in] sched Scheduler handle
+ * @param[in] job_id Index returned by `sensor_bus_sched_add_job()`
+ * @param[out] stats Statistics
+ * @return
+ *          - ESP_ERR_INVALID_ARG   if parameter is invalid
+ *          - ESP_OK                on success
+ */
+esp_err_t sensor_bus_sched_get_job_stats(sensor_bus_sched_handle_t sched, int job_id, sensor_bus_job_stats_t *stats);
+
+/**
+ * @brief Log the layout and the statistics of every job
+ *
+ * @param[in] sched Scheduler handle
+ */
+void sensor_bus_sched_dump(sensor_bus_sched_handle_t sched);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,476 @@
+/*
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "sensor_bus_scheduler.h"
+
+#define SENSOR_BUS_DEFAULT_MAX_FRAMES   1000
+#define SENSOR_BUS_DEFAULT_MAX_JOBS     8
+#define SENSOR_BUS_DEFAULT_TASK_STACK   4096
+
+static const char *TAG = "sensor_bus_sched";
+
+typedef struct {
+    sensor_bus_job_config_t config;
+    sensor_bus_job_stats_t stats;
+} sensor_bus_job_t;
+
+// One job instance in the table, frames list their slots in running order
+typedef struct {
+    uint8_t job;
+    bool wrapped;           // Released in the previous hyperperiod
+    uint32_t wait_us;       // From the release to the start of the frame it runs in
+} sensor_bus_slot_t;
+
+// Job instance while the table is built, carrying its own sort keys
+typedef struct {
+    uint8_t job;
+    uint8_t priority;
+    uint32_t release_us;
+    uint64_t deadline_us;   // Absolute
+    uint32_t frame;         // Not wrapped, may be past the hyperperiod
+} sensor_bus_instance_t;
+
+struct sensor_bus_sched_t {
+    sensor_bus_sched_config_t config;
+    sensor_bus_job_t *jobs;
+    uint8_t job_count;
+    // Slots of frame f are slots[frame_first[f]] to slots[frame_first[f + 1] - 1]
+    sensor_bus_slot_t *slots;
+    uint32_t *frame_first;
+    uint32_t slot_count;
+    uint32_t minor_frame_us;
+    uint32_t hyperperiod_us;
+    uint32_t frames;
+    float planned_utilization;
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+    SemaphoreHandle_t stopped;
+    volatile bool running;
+    int64_t start_us;
+    uint64_t frame_seq;
+    uint64_t busy_us;
+    uint32_t frames_run;
+    uint32_t frames_skipped;
+    uint32_t deadline_misses;
+    portMUX_TYPE lock;
+};
+
+static uint64_t sensor_bus_gcd(uint64_t a, uint64_t b)
+{
+    while (b) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static inline uint32_t sensor_bus_deadline(const sensor_bus_job_config_t *job)
+{
+    return job->deadline_us ? job->deadline_us : job->period_us;
+}
+
+static inline const char *sensor_bus_name(const sensor_bus_job_t *job)
+{
+    return job->config.name ? job->config.name : "?";
+}
+
+// Release time first, then priority, then the earlier absolute deadline
+static int sensor_bus_instance_cmp(const void *a, const void *b)
+{
+    const sensor_bus_instance_t *ia = (const sensor_bus_instance_t *)a;
+    const sensor_bus_instance_t *ib = (const sensor_bus_instance_t *)b;
+    if (ia->release_us != ib->release_us) {
+        return ia->release_us < ib->release_us ? -1 : 1;
+    }
+    if (ia->priority != ib->priority) {
+        return ia->priority > ib->priority ? -1 : 1;
+    }
+    if (ia->deadline_us != ib->deadline_us) {
+        return ia->deadline_us < ib->deadline_us ? -1 : 1;
+    }
+    return (int)ia->job - (int)ib->job;
+}
+
+static void sensor_bus_free_table(sensor_bus_sched_handle_t sched)
+{
+    free(sched->slots);
+    free(sched->frame_first);
+    sched->slots = NULL;
+    sched->frame_first = NULL;
+    sched->slot_count = 0;
+}
+
+static esp_err_t sensor_bus_build(sensor_bus_sched_handle_t sched)
+{
+    esp_err_t ret = ESP_OK;
+    uint64_t frame = sched->config.minor_frame_us;
+    uint64_t hyper = 1;
+    float utilization = 0;
+
+    for (int i = 0; i < sched->job_count; i++) {
+        const sensor_bus_job_config_t *job = &sched->jobs[i].config;
+        frame = frame ? frame : job->period_us;
+        if (!sched->config.minor_frame_us) {
+            frame = sensor_bus_gcd(frame, job->period_us);
+        }
+        hyper = hyper / sensor_bus_gcd(hyper, job->period_us) * job->period_us;
+        ESP_RETURN_ON_FALSE(hyper <= UINT32_MAX, ESP_ERR_INVALID_SIZE, TAG, "hyperperiod over %" PRIu32 " us", UINT32_MAX);
+        utilization += (float)job->cost_us / job->period_us;
+    }
+    for (int i = 0; i < sched->job_count; i++) {
+        const sensor_bus_job_t *job = &sched->jobs[i];
+        ESP_RETURN_ON_FALSE(job->config.period_us % frame == 0, ESP_ERR_INVALID_ARG, TAG,
+                            "%s: period %" PRIu32 " us is not a multiple of the %" PRIu32 " us minor frame",
+                            sensor_bus_name(job), job->config.period_us, (uint32_t)frame);
+        ESP_RETURN_ON_FALSE(job->config.cost_us <= frame, ESP_ERR_NOT_FOUND, TAG,
+                            "%s: cost %" PRIu32 " us is longer than the %" PRIu32 " us minor frame",
+                            sensor_bus_name(job), job->config.cost_us, (uint32_t)frame);
+    }
+    uint32_t frames = hyper / frame;
+    ESP_RETURN_ON_FALSE(frames <= sched->config.max_frames, ESP_ERR_INVALID_SIZE, TAG,
+                        "%" PRIu32 " frames of %" PRIu32 " us in the hyperperiod, max_frames is %" PRIu32,
+                        frames, (uint32_t)frame, sched->config.max_frames);
+    if (utilization > 1.0f) {
+        ESP_LOGE(TAG, "bus utilization %.1f%%", utilization * 100);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint32_t count = 0;
+    for (int i = 0; i < sched->job_count; i++) {
+        count += hyper / sched->jobs[i].config.period_us;
+    }
+    sensor_bus_instance_t *instances = calloc(count, sizeof(sensor_bus_instance_t));
+    uint32_t *used = calloc(frames, sizeof(uint32_t));
+    sched->slots = calloc(count, sizeof(sensor_bus_slot_t));
+    sched->frame_first = calloc(frames + 1, sizeof(uint32_t));
+    ESP_GOTO_ON_FALSE(instances && used && sched->slots && sched->frame_first, ESP_ERR_NO_MEM, err, TAG,
+                      "no mem for %" PRIu32 " job instances", count);
+
+    uint32_t n = 0;
+    for (int i = 0; i < sched->job_count; i++) {
+        const sensor_bus_job_config_t *job = &sched->jobs[i].config;
+        for (uint32_t t = 0; t < hyper; t += job->period_us) {
+            instances[n].job = i;
+            instances[n].priority = job->priority;
+            instances[n].release_us = t;
+            instances[n].deadline_us = (uint64_t)t + sensor_bus_deadline(job);
+            n++;
+        }
+        sched->jobs[i].stats.offset_us = UINT32_MAX;
+    }
+    qsort(instances, count, sizeof(sensor_bus_instance_t), sensor_bus_instance_cmp);
+
+    // Each instance goes to the first frame from its release with room left.
+    // Later frames only end later, so if that one misses the deadline all do.
+    for (uint32_t i = 0; i < count; i++) {
+        sensor_bus_instance_t *inst = &instances[i];
+        sensor_bus_job_t *job = &sched->jobs[inst->job];
+        uint32_t f = inst->release_us / frame;
+        uint32_t k;
+        for (k = 0; k < frames; k++) {
+            if (used[(f + k) % frames] + job->config.cost_us <= frame) {
+                break;
+            }
+        }
+        uint64_t start = (uint64_t)(f + k) * frame + (k < frames ? used[(f + k) % frames] : 0);
+        ESP_GOTO_ON_FALSE(k < frames && start + job->config.cost_us <= inst->release_us + sensor_bus_deadline(&job->config),
+                          ESP_ERR_NOT_FOUND, err, TAG, "%s released at %" PRIu32 " us misses its deadline",
+                          sensor_bus_name(job), inst->release_us);
+        if (inst->release_us == 0) {
+            job->stats.offset_us = start;
+        }
+        inst->frame = f + k;
+        used[(f + k) % frames] += job->config.cost_us;
+        sched->frame_first[(f + k) % frames + 1]++;
+    }
+
+    // Counting sort by frame, keeping the placement order inside a frame
+    for (uint32_t f = 0; f < frames; f++) {
+        sched->frame_first[f + 1] += sched->frame_first[f];
+    }
+    memset(used, 0, frames * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t f = instances[i].frame % frames;
+        sensor_bus_slot_t *slot = &sched->slots[sched->frame_first[f] + used[f]++];
+        slot->job = instances[i].job;
+        slot->wrapped = instances[i].frame >= frames;
+        slot->wait_us = (uint64_t)instances[i].frame * frame - instances[i].release_us;
+    }
+
+    sched->slot_count = count;
+    sched->minor_frame_us = frame;
+    sched->hyperperiod_us = hyper;
+    sched->frames = frames;
+    sched->planned_utilization = utilization;
+    free(instances);
+    free(used);
+    return ESP_OK;
+
+err:
+    free(instances);
+    free(used);
+    sensor_bus_free_table(sched);
+    return ret;
+}
+
+static void sensor_bus_timer_cb(void *arg)
+{
+    sensor_bus_sched_handle_t sched = (sensor_bus_sched_handle_t)arg;
+    xTaskNotifyGive(sched->task);
+}
+
+static void sensor_bus_task(void *arg)
+{
+    sensor_bus_sched_handle_t sched = (sensor_bus_sched_handle_t)arg;
+
+    while (1) {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!sched->running) {
+            break;
+        }
+        // Frames whose start passed while the previous one ran are dropped,
+        // running them late would only push the next ones back
+        if (ticks > 1) {
+            portENTER_CRITICAL(&sched->lock);
+            sched->frames_skipped += ticks - 1;
+            portEXIT_CRITICAL(&sched->lock);
+            sched->frame_seq += ticks - 1;
+        }
+        uint32_t f = sched->frame_seq % sched->frames;
+        int64_t frame_start = sched->start_us + (int64_t)sched->frame_seq * sched->minor_frame_us;
+        uint32_t busy = 0;
+
+        for (uint32_t i = sched->frame_first[f]; i < sched->frame_first[f + 1]; i++) {
+            const sensor_bus_slot_t *slot = &sched->slots[i];
+            if (slot->wrapped && sched->frame_seq < sched->frames) {
+                // Released in the hyperperiod before the start, which never ran
+                continue;
+            }
+            sensor_bus_job_t *job = &sched->jobs[slot->job];
+            int64_t t0 = esp_timer_get_time();
+            esp_err_t err = job->config.read(job->config.user_ctx);
+            int64_t t1 = esp_timer_get_time();
+            uint32_t exec = t1 - t0;
+            int64_t response = t1 - (frame_start - slot->wait_us);
+            bool missed = response > sensor_bus_deadline(&job->config);
+            busy += exec;
+
+            portENTER_CRITICAL(&sched->lock);
+            sensor_bus_job_stats_t *stats = &job->stats;
+            stats->runs++;
+            stats->errors += err != ESP_OK;
+            stats->cost_overruns += exec > job->config.cost_us;
+            stats->deadline_misses += missed;
+            sched->deadline_misses += missed;
+            if (exec > stats->max_exec_us) {
+                stats->max_exec_us = exec;
+            }
+            if (response > stats->max_response_us) {
+                stats->max_response_us = response;
+            }
+            portEXIT_CRITICAL(&sched->lock);
+        }
+
+        portENTER_CRITICAL(&sched->lock);
+        sched->busy_us += busy;
+        sched->frames_run++;
+        portEXIT_CRITICAL(&sched->lock);
+        sched->frame_seq++;
+    }
+
+    xSemaphoreGive(sched->stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t sensor_bus_sched_new(const sensor_bus_sched_config_t *config, sensor_bus_sched_handle_t *ret_sched)
+{
+    esp_err_t ret = ESP_OK;
+    sensor_bus_sched_handle_t sched = NULL;
+    ESP_RETURN_ON_FALSE(ret_sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    sched = calloc(1, sizeof(struct sensor_bus_sched_t));
+    ESP_GOTO_ON_FALSE(sched, ESP_ERR_NO_MEM, err, TAG, "no mem for scheduler");
+    const sensor_bus_sched_config_t defaults = SENSOR_BUS_SCHED_CONFIG_DEFAULT();
+    sched->config = config ? *config : defaults;
+    if (!sched->config.max_frames) {
+        sched->config.max_frames = SENSOR_BUS_DEFAULT_MAX_FRAMES;
+    }
+    if (!sched->config.max_jobs) {
+        sched->config.max_jobs = SENSOR_BUS_DEFAULT_MAX_JOBS;
+    }
+    if (!sched->config.task_priority) {
+        sched->config.task_priority = configMAX_PRIORITIES - 2;
+    }
+    if (!sched->config.task_stack) {
+        sched->config.task_stack = SENSOR_BUS_DEFAULT_TASK_STACK;
+    }
+    portMUX_INITIALIZE(&sched->lock);
+
+    sched->jobs = calloc(sched->config.max_jobs, sizeof(sensor_bus_job_t));
+    ESP_GOTO_ON_FALSE(sched->jobs, ESP_ERR_NO_MEM, err, TAG, "no mem for jobs");
+    sched->stopped = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(sched->stopped, ESP_ERR_NO_MEM, err, TAG, "no mem for semaphore");
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = sensor_bus_timer_cb,
+        .arg = sched,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "sensor_bus",
+    };
+    ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &sched->timer), err, TAG, "create timer failed");
+
+    *ret_sched = sched;
+    return ESP_OK;
+
+err:
+    if (sched) {
+        if (sched->stopped) {
+            vSemaphoreDelete(sched->stopped);
+        }
+        free(sched->jobs);
+        free(sched);
+    }
+    return ret;
+}
+
+esp_err_t sensor_bus_sched_add_job(sensor_bus_sched_handle_t sched, const sensor_bus_job_config_t *job_config,
+                                   int *ret_job_id)
+{
+    ESP_RETURN_ON_FALSE(sched && job_config && job_config->read && job_config->period_us, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    ESP_RETURN_ON_FALSE(!sched->running, ESP_ERR_INVALID_STATE, TAG, "scheduler is running");
+    ESP_RETURN_ON_FALSE(sched->job_count < sched->config.max_jobs, ESP_ERR_NO_MEM, TAG, "max_jobs reached");
+
+    sensor_bus_job_t *job = &sched->jobs[sched->job_count];
+    memset(job, 0, sizeof(sensor_bus_job_t));
+    job->config = *job_config;
+    if (ret_job_id) {
+        *ret_job_id = sched->job_count;
+    }
+    sched->job_count++;
+    return ESP_OK;
+}
+
+esp_err_t sensor_bus_sched_start(sensor_bus_sched_handle_t sched)
+{
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!sched->running && sched->job_count, ESP_ERR_INVALID_STATE, TAG,
+                        "already running or no jobs");
+
+    sensor_bus_free_table(sched);
+    for (int i = 0; i < sched->job_count; i++) {
+        memset(&sched->jobs[i].stats, 0, sizeof(sensor_bus_job_stats_t));
+    }
+    ESP_RETURN_ON_ERROR(sensor_bus_build(sched), TAG, "no schedule");
+
+    sched->frame_seq = 0;
+    sched->busy_us = 0;
+    sched->frames_run = 0;
+    sched->frames_skipped = 0;
+    sched->deadline_misses = 0;
+    sched->running = true;
+    if (xTaskCreatePinnedToCore(sensor_bus_task, "sensor_bus", sched->config.task_stack, sched,
+                                sched->config.task_priority, &sched->task, sched->config.task_core) != pdPASS) {
+        sched->running = false;
+        sensor_bus_free_table(sched);
+        ESP_LOGE(TAG, "create task failed");
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Frame 0 starts now, the timer brings the following ones
+    sched->start_us = esp_timer_get_time();
+    xTaskNotifyGive(sched->task);
+    esp_timer_start_periodic(sched->timer, sched->minor_frame_us);
+    ESP_LOGI(TAG, "%d jobs, %" PRIu32 " frames of %" PRIu32 " us, bus %.1f%% busy", sched->job_count,
+             sched->frames, sched->minor_frame_us, sched->planned_utilization * 100);
+    return ESP_OK;
+}
+
+esp_err_t sensor_bus_sched_stop(sensor_bus_sched_handle_t sched)
+{
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(sched->running, ESP_ERR_INVALID_STATE, TAG, "not running");
+
+    esp_timer_stop(sched->timer);
+    sched->running = false;
+    xTaskNotifyGive(sched->task);
+    xSemaphoreTake(sched->stopped, portMAX_DELAY);
+    sched->task = NULL;
+    return ESP_OK;
+}
+
+esp_err_t sensor_bus_sched_del(sensor_bus_sched_handle_t sched)
+{
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (sched->running) {
+        sensor_bus_sched_stop(sched);
+    }
+    esp_timer_delete(sched->timer);
+    vSemaphoreDelete(sched->stopped);
+    sensor_bus_free_table(sched);
+    free(sched->jobs);
+    free(sched);
+    return ESP_OK;
+}
+
+esp_err_t sensor_bus_sched_get_stats(sensor_bus_sched_handle_t sched, sensor_bus_sched_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(sched && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    int64_t elapsed = sched->running ? esp_timer_get_time() - sched->start_us : 0;
+    portENTER_CRITICAL(&sched->lock);
+    stats->minor_frame_us = sched->minor_frame_us;
+    stats->hyperperiod_us = sched->hyperperiod_us;
+    stats->frames = sched->frames;
+    stats->instances = sched->slot_count;
+    stats->planned_utilization = sched->planned_utilization;
+    stats->measured_utilization = elapsed > 0 ? (float)sched->busy_us / elapsed : 0;
+    stats->frames_run = sched->frames_run;
+    stats->frames_skipped = sched->frames_skipped;
+    stats->deadline_misses = sched->deadline_misses;
+    portEXIT_CRITICAL(&sched->lock);
+    return ESP_OK;
+}
+
+esp_err_t sensor_bus_sched_get_job_stats(sensor_bus_sched_handle_t sched, int job_id, sensor_bus_job_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(sched && stats && job_id >= 0 && job_id < sched->job_count, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+
+    portENTER_CRITICAL(&sched->lock);
+    *stats = sched->jobs[job_id].stats;
+    portEXIT_CRITICAL(&sched->lock);
+    return ESP_OK;
+}
+
+void sensor_bus_sched_dump(sensor_bus_sched_handle_t sched)
+{
+    sensor_bus_sched_stats_t s;
+    if (sensor_bus_sched_get_stats(sched, &s) != ESP_OK) {
+        return;
+    }
+    ESP_LOGI(TAG, "frame %" PRIu32 " us, hyperperiod %" PRIu32 " us, bus %.1f%% planned %.1f%% measured",
+             s.minor_frame_us, s.hyperperiod_us, s.planned_utilization * 100, s.measured_utilization * 100);
+    ESP_LOGI(TAG, "frames run %" PRIu32 " skipped %" PRIu32 ", deadline misses %" PRIu32,
+             s.frames_run, s.frames_skipped, s.deadline_misses);
+    for (int i = 0; i < sched->job_count; i++) {
+        sensor_bus_job_stats_t js;
+        sensor_bus_sched_get_job_stats(sched, i, &js);
+        const sensor_bus_job_config_t *c = &sched->jobs[i].config;
+        ESP_LOGI(TAG, "  %-12s every %7" PRIu32 " us at +%6" PRIu32 " us, runs %" PRIu32 " errors %" PRIu32
+                 " misses %" PRIu32 " overruns %" PRIu32 ", exec max %" PRIu32 "/%" PRIu32 " us, response max %" PRIu32 " us",
+                 sensor_bus_name(&sched->jobs[i]), c->period_us, js.offset_us, js.runs, js.errors,
+                 js.deadline_misses, js.cost_overruns, js.max_exec_us, c->cost_us, js.max_response_us);
+    }
+}
@@ -0,0 +1,327 @@
+/// \file		hostBench.c
+///
+/// \brief	Headless render benchmark of the UI, for the host
+///
+/// Renders scripted scenarios into a memory frame buffer with the same
+/// resolution and draw buffer as the board and prints the time spent in
+/// lv_timer_handler() and the pixels flushed for every frame. The flush only
+/// copies into memory, so the numbers are the LVGL side of the frame cost.
+///
+///     lilygo_ui_bench <scenario> [--frames N] [--csv] [--budget-us N]
+///
+/// With --budget-us the exit code is 2 when the p95 frame time is over the
+/// budget, so a CI job can gate UI changes on it.
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lvgl.h"
+#include "demos/lv_demos.h"
+#include "ui.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+// AMOLED_HEIGHT x AMOLED_WIDTH of product_pins.h, landscape
+#define HOST_HOR_RES                240
+#define HOST_VER_RES                135
+// Same draw buffer as main.cpp
+#define HOST_DRAW_BUF_LINES         20
+#define HOST_DEFAULT_FRAMES         300
+
+#define HOST_CHART_POINTS           120
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    const char *name;
+    void (*setup)(lv_obj_t *screen);
+    void (*step)(uint32_t frame);   // Before every frame, may be NULL
+} _scenario_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+static void _flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+static uint64_t _nowNs(void);
+static int _compareU32(const void *a, const void *b);
+static uint32_t _fbHash(void);
+static void _usage(const char *argv0);
+
+static void _labelsSetup(lv_obj_t *screen);
+static void _labelsStep(uint32_t frame);
+static void _chartSetup(lv_obj_t *screen);
+static void _chartStep(uint32_t frame);
+static void _demoWidgets(lv_obj_t *screen);
+static void _demoBenchmark(lv_obj_t *screen);
+static void _demoStress(lv_obj_t *screen);
+static void _demoMusic(lv_obj_t *screen);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+static const _scenario_t scenarios[] = {
+    { "labels",         _labelsSetup,   _labelsStep },
+    { "chart",          _chartSetup,    _chartStep },
+    { "demo_widgets",   _demoWidgets,   NULL },
+    { "demo_benchmark", _demoBenchmark, NULL },
+    { "demo_stress",    _demoStress,    NULL },
+    { "demo_music",     _demoMusic,     NULL },
+};
+
+static lv_color_t frameBuffer[HOST_HOR_RES * HOST_VER_RES];
+static lv_color_t drawBuffer[HOST_HOR_RES * HOST_DRAW_BUF_LINES];
+static lv_disp_draw_buf_t dispBuf;
+static lv_disp_drv_t dispDrv;
+
+// Reset before every frame
+static uint32_t framePixels = 0;
+static uint32_t frameFlushes = 0;
+
+static lv_obj_t *uiLabel = NULL;
+static lv_obj_t *chart = NULL;
+static lv_chart_series_t *chartSeries = NULL;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+    const _scenario_t *scenario = NULL;
+    uint32_t frames = HOST_DEFAULT_FRAMES;
+    uint32_t budgetUs = 0;
+    int csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--budget-us") == 0 && i + 1 < argc) {
+            budgetUs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+                if (strcmp(argv[i], scenarios[s].name) == 0) {
+                    scenario = &scenarios[s];
+                }
+            }
+        }
+    }
+    if (!scenario || frames < 2) {
+        _usage(argv[0]);
+        return 1;
+    }
+
+    lv_init();
+    lv_disp_draw_buf_init(&dispBuf, drawBuffer, NULL, HOST_HOR_RES * HOST_DRAW_BUF_LINES);
+    lv_disp_drv_init(&dispDrv);
+    dispDrv.hor_res = HOST_HOR_RES;
+    dispDrv.ver_res = HOST_VER_RES;
+    dispDrv.flush_cb = _flush;
+    dispDrv.draw_buf = &dispBuf;
+    lv_disp_drv_register(&dispDrv);
+
+    scenario->setup(lv_scr_act());
+
+    uint32_t *frameUs = malloc(frames * sizeof(uint32_t));
+    if (!frameUs) {
+        return 1;
+    }
+    uint64_t totalPixels = 0;
+    uint64_t totalFlushes = 0;
+
+    if (csv) {
+        printf("frame,render_us,pixels,flushes\n");
+    }
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        if (scenario->step) {
+            scenario->step(frame);
+        }
+        framePixels = 0;
+        frameFlushes = 0;
+
+        // One refresh period per frame, as on the board
+        lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+        uint64_t start = _nowNs();
+        lv_timer_handler();
+        frameUs[frame] = (uint32_t)((_nowNs() - start) / 1000);
+
+        if (frame > 0) {
+            totalPixels += framePixels;
+            totalFlushes += frameFlushes;
+        }
+        if (csv) {
+            printf("%lu,%lu,%lu,%lu\n", (unsigned long)frame, (unsigned long)frameUs[frame],
+                   (unsigned long)framePixels, (unsigned long)frameFlushes);
+        }
+    }
+
+    // The first frame draws the whole screen, it is reported on its own
+    uint32_t firstUs = frameUs[0];
+    uint32_t count = frames - 1;
+    uint64_t sumUs = 0;
+    for (uint32_t i = 1; i < frames; i++) {
+        sumUs += frameUs[i];
+    }
+    qsort(&frameUs[1], count, sizeof(uint32_t), _compareU32);
+    uint32_t p50 = frameUs[1 + count / 2];
+    uint32_t p95 = frameUs[1 + (count - 1) * 95 / 100];
+    uint32_t maxUs = frameUs[frames - 1];
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    printf("scenario=%s frames=%lu first_us=%lu avg_us=%lu p50_us=%lu p95_us=%lu max_us=%lu "
+           "px_per_frame=%lu flushes_per_frame=%lu.%02lu mem_max_used=%lu fb_hash=0x%08lx\n",
+           scenario->name, (unsigned long)count, (unsigned long)firstUs,
+           (unsigned long)(sumUs / count), (unsigned long)p50, (unsigned long)p95, (unsigned long)maxUs,
+           (unsigned long)(totalPixels / count),
+           (unsigned long)(totalFlushes / count), (unsigned long)(totalFlushes * 100 / count % 100),
+           (unsigned long)mon.max_used, (unsigned long)_fbHash());
+
+    free(frameUs);
+
+    if (budgetUs && p95 > budgetUs) {
+        fprintf(stderr, "%s: p95 %lu us over the %lu us budget\n",
+                scenario->name, (unsigned long)p95, (unsigned long)budgetUs);
+        return 2;
+    }
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void _flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&frameBuffer[y * HOST_HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
+        color_p += w;
+    }
+    framePixels += lv_area_get_size(area);
+    frameFlushes++;
+    lv_disp_flush_ready(drv);
+}
+
+uint64_t _nowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int _compareU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+uint32_t _fbHash(void)
+{
+    // FNV-1a of the final frame, changes whenever the rendering does
+    const uint8_t *p = (const uint8_t *)frameBuffer;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(frameBuffer); i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void _usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s <scenario> [--frames N] [--csv] [--budget-us N]\nscenarios:", argv0);
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        fprintf(stderr, " %s", scenarios[s].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+void _labelsSetup(lv_obj_t *screen)
+{
+    uiLabel = uiCreate(screen);
+}
+
+void _labelsStep(uint32_t frame)
+{
+    // What displayServerSetText() does on the board
+    lv_label_set_text_fmt(uiLabel, "Value %lu", (unsigned long)((frame * 37) % 4096));
+}
+
+void _chartSetup(lv_obj_t *screen)
+{
+    chart = lv_chart_create(screen);
+    lv_obj_set_size(chart, HOST_HOR_RES, HOST_VER_RES);
+    lv_obj_center(chart);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_point_count(chart, HOST_CHART_POINTS);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR);
+    chartSeries = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
+}
+
+void _chartStep(uint32_t frame)
+{
+    // Triangle wave, one new sample per frame scrolls the whole plot
+    uint32_t phase = (frame * 3) % 200;
+    lv_chart_set_next_value(chart, chartSeries, phase < 100 ? phase : 200 - phase);
+}
+
+void _demoWidgets(lv_obj_t *screen)
+{
+    LV_UNUSED(screen);
+    lv_demo_widgets();
+}
+
+void _demoBenchmark(lv_obj_t *screen)
+{
+    LV_UNUSED(screen);
+    // Scenes advance with the simulated tick, one per refresh period
+    lv_demo_benchmark(LV_DEMO_BENCHMARK_MODE_REAL);
+}
+
+void _demoStress(lv_obj_t *screen)
+{
+    LV_UNUSED(screen);
+    lv_demo_stress();
+}
+
+void _demoMusic(lv_obj_t *screen)
+{
+    LV_UNUSED(screen);
+    lv_demo_music();
+}
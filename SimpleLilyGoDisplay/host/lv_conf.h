@@ -0,0 +1,115 @@
+/// \file		lv_conf.h
+///
+/// \brief	LVGL configuration for the host build, mirrors sdkconfig
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#if 1
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+// Options not listed here keep the lv_conf_internal.h defaults, which are
+// also the Kconfig defaults used on the board
+
+/*====================
+   COLOR SETTINGS
+ *====================*/
+#define LV_COLOR_DEPTH              16
+#define LV_COLOR_16_SWAP            0
+#define LV_COLOR_SCREEN_TRANSP      0
+#define LV_COLOR_MIX_ROUND_OFS      128
+#define LV_COLOR_CHROMA_KEY         lv_color_hex(0x00ff00)
+
+/*=========================
+   MEMORY SETTINGS
+ *=========================*/
+#define LV_MEM_CUSTOM               0
+// The board gives LVGL 32 KB, the demos refuse to build with less than
+// 38 KB. The heap size doesn't change the render cost.
+#define LV_MEM_SIZE                 (64U * 1024U)
+#define LV_MEM_BUF_MAX_NUM          16
+
+/*====================
+   HAL SETTINGS
+ *====================*/
+#define LV_DISP_DEF_REFR_PERIOD     30
+#define LV_INDEV_DEF_READ_PERIOD    30
+// Time is driven by the benchmark with lv_tick_inc(), frames are reproducible
+#define LV_TICK_CUSTOM              0
+#define LV_DPI_DEF                  130
+
+/*========================
+ * RENDERING CONFIGURATION
+ *========================*/
+#define LV_DRAW_COMPLEX             1
+#define LV_SHADOW_CACHE_SIZE        0
+#define LV_CIRCLE_CACHE_SIZE        4
+#define LV_LAYER_SIMPLE_BUF_SIZE    (24 * 1024)
+#define LV_IMG_CACHE_DEF_SIZE       0
+#define LV_GRADIENT_MAX_STOPS       2
+#define LV_GRAD_CACHE_DEF_SIZE      0
+#define LV_DISP_ROT_MAX_BUF         (10 * 1024)
+
+/*-------------
+ * Logging
+ *-----------*/
+#define LV_USE_LOG                  0
+#define LV_USE_PERF_MONITOR         0
+#define LV_USE_MEM_MONITOR          0
+
+/*-------------
+ * Asserts
+ *-----------*/
+#define LV_USE_ASSERT_NULL          1
+#define LV_USE_ASSERT_MALLOC        1
+#define LV_USE_ASSERT_STYLE         0
+#define LV_USE_ASSERT_MEM_INTEGRITY 0
+#define LV_USE_ASSERT_OBJ           0
+
+#define LV_USE_USER_DATA            1
+
+/*==================
+ *   FONT USAGE
+ *===================*/
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_DEFAULT             &lv_font_montserrat_14
+// Only used by the demos, the board UI sticks to montserrat 14
+#define LV_FONT_MONTSERRAT_12       1
+#define LV_FONT_MONTSERRAT_16       1
+#define LV_FONT_MONTSERRAT_20       1
+#define LV_FONT_MONTSERRAT_22       1
+#define LV_FONT_MONTSERRAT_24       1
+#define LV_FONT_MONTSERRAT_26       1
+#define LV_FONT_MONTSERRAT_32       1
+#define LV_USE_FONT_PLACEHOLDER     1
+
+/*==================
+ *  WIDGET USAGE
+ *================*/
+#define LV_USE_CHART                1
+#define LV_USE_SNAPSHOT             1
+
+/*==================
+* EXAMPLES
+*==================*/
+#define LV_BUILD_EXAMPLES           0
+
+/*===================
+ * DEMO USAGE
+ ====================*/
+#define LV_USE_DEMO_WIDGETS         1
+#define LV_USE_DEMO_BENCHMARK       1
+#define LV_USE_DEMO_STRESS          1
+#define LV_USE_DEMO_MUSIC           1
+
+#endif // LV_CONF_H
+#endif // Content enable
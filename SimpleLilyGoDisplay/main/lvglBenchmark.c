@@ -0,0 +1,208 @@
+/// \file		lvglBenchmark.c
+///
+/// \brief	lv_demo_benchmark boot mode with per-scene result capture
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "lvgl.h"
+#include "demos/lv_demos.h"
+#include "product_pins.h"
+#include "displayStats.h"
+#include "lvglBenchmark.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                           DEFINES AND MACROS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+// The demo runs every scene twice, with and without opacity
+#define BENCH_MAX_SCENES            80
+#define BENCH_NAME_LEN              40
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      LOCAL TYPEDEFS AND STRUCTURES                       //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    displayStatsReport_t report;
+} _scene_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                        LOCAL FUNCTIONS PROTOTYPES                        //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Text of the demo title label, which names the running scene
+ *
+ * The demo doesn't report scene changes, but its title is the first child
+ * of the screen and is renamed at the start of every scene.
+ */
+static const char *_sceneTitle(void);
+
+static void _closeScene(void);
+static void _finished(void);
+static void _printScene(const _scene_t *scene);
+static void _printString(const char *text);
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                      STATIC VARIABLES AND CONSTANTS                      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+static const char *TAG = "lvglBench";
+
+static _scene_t scenes[BENCH_MAX_SCENES];
+static int sceneCount = 0;
+static bool sceneOpen = false;
+static bool finished = false;
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+void lvglBenchmarkStart(void)
+{
+    ESP_LOGI(TAG, "Running lv_demo_benchmark, pclk=%lu draw_buf_lines=%u",
+             (unsigned long)DISPLAY_PIXEL_CLOCK_HZ, DISPLAY_DRAW_BUF_LINES);
+
+    sceneCount = 0;
+    sceneOpen = false;
+    finished = false;
+
+    lv_demo_benchmark_set_finished_cb(_finished);
+    // Scenes are redrawn as fast as possible, through our flush path
+    lv_demo_benchmark(LV_DEMO_BENCHMARK_MODE_RENDER_AND_DRIVER);
+}
+
+void lvglBenchmarkProcess(void)
+{
+    if (finished) {
+        return;
+    }
+
+    const char *title = _sceneTitle();
+    if (!title || title[0] == '\0') {
+        return;
+    }
+    if (sceneOpen && strncmp(title, scenes[sceneCount].name, BENCH_NAME_LEN - 1) == 0) {
+        return;
+    }
+
+    _closeScene();
+    if (sceneCount >= BENCH_MAX_SCENES) {
+        return;
+    }
+
+    _scene_t *scene = &scenes[sceneCount];
+    strncpy(scene->name, title, BENCH_NAME_LEN - 1);
+    scene->name[BENCH_NAME_LEN - 1] = '\0';
+    sceneOpen = true;
+    displayStatsSegmentBegin();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                              LOCAL FUNCTIONS                             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+const char *_sceneTitle(void)
+{
+    lv_obj_t *title = lv_obj_get_child(lv_scr_act(), 0);
+    if (!title || !lv_obj_check_type(title, &lv_label_class)) {
+        return NULL;
+    }
+    return lv_label_get_text(title);
+}
+
+void _closeScene(void)
+{
+    if (!sceneOpen) {
+        return;
+    }
+    sceneOpen = false;
+
+    _scene_t *scene = &scenes[sceneCount++];
+    displayStatsSegmentEnd(&scene->report);
+
+    printf("BENCH_SCENE ");
+    _printScene(scene);
+    printf("\n");
+}
+
+void _finished(void)
+{
+    _closeScene();
+    finished = true;
+
+    uint32_t fpsSum = 0;
+    for (int i = 0; i < sceneCount; i++) {
+        fpsSum += scenes[i].report.fps;
+    }
+
+    // One line, so a host script can pick it out of the console log
+    printf("BENCH_SUMMARY {\"pclk_hz\":%lu,\"draw_buf_lines\":%u,\"hor_res\":%u,\"ver_res\":%u,"
+           "\"fps_avg\":%lu,\"scenes\":[",
+           (unsigned long)DISPLAY_PIXEL_CLOCK_HZ, DISPLAY_DRAW_BUF_LINES, AMOLED_HEIGHT, AMOLED_WIDTH,
+           (unsigned long)(sceneCount ? fpsSum / sceneCount : 0));
+    for (int i = 0; i < sceneCount; i++) {
+        if (i) {
+            printf(",");
+        }
+        _printScene(&scenes[i]);
+    }
+    printf("]}\n");
+
+    ESP_LOGI(TAG, "Benchmark done, %d scenes", sceneCount);
+}
+
+void _printScene(const _scene_t *scene)
+{
+    const displayStatsReport_t *r = &scene->report;
+
+    printf("{\"name\":");
+    _printString(scene->name);
+    printf(",\"fps\":%lu,\"dma_per_s\":%lu,"
+           "\"render_avg_us\":%lu,\"render_p50_last64_us\":%lu,\"render_p95_last64_us\":%lu,\"render_max_us\":%lu,"
+           "\"flush_avg_us\":%lu,\"flush_p50_last64_us\":%lu,\"flush_p95_last64_us\":%lu,\"flush_max_us\":%lu,"
+           "\"mem_max_used\":%lu}",
+           (unsigned long)r->fps, (unsigned long)r->dmaPerSec,
+           (unsigned long)r->renderUs.avg, (unsigned long)r->renderUs.p50,
+           (unsigned long)r->renderUs.p95, (unsigned long)r->renderUs.max,
+           (unsigned long)r->flushUs.avg, (unsigned long)r->flushUs.p50,
+           (unsigned long)r->flushUs.p95, (unsigned long)r->flushUs.max,
+           (unsigned long)r->memMaxUsed);
+}
+
+void _printString(const char *text)
+{
+    putchar('"');
+    for (; *text; text++) {
+        if (*text == '"' || *text == '\\') {
+            putchar('\\');
+        }
+        putchar(*text);
+    }
+    putchar('"');
+}
@@ -0,0 +1,57 @@
+/// \file		lvglBenchmark.h
+///
+/// \brief	lv_demo_benchmark boot mode with per-scene result capture
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef LVGL_BENCHMARK_H
+#define LVGL_BENCHMARK_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Start the LVGL benchmark scenes on the active screen
+ *
+ * Use as the display server onStart. Frame statistics must be enabled.
+ */
+void lvglBenchmarkStart(void);
+
+/**
+ * @brief Follow the scene changes and print the results
+ *
+ * Use as the display server onFrame. Every scene prints one JSON line
+ * prefixed with "BENCH_SCENE ", the end of the run one line prefixed with
+ * "BENCH_SUMMARY " holding all the scenes and the display configuration.
+ */
+void lvglBenchmarkProcess(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_BENCHMARK_H
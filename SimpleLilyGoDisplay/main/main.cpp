@@ -13,7 +13,6 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/semphr.h"
 #include "esp_timer.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_vendor.h"
@@ -27,16 +26,19 @@
 #include "demos/lv_demos.h"
 #include "tft_driver.h"
 #include "product_pins.h"
+#include "displayStats.h"
+#include "displayServer.h"
+#include "ui.h"
+#include "lvglBenchmark.h"
 
 static const char *TAG = "main";
 
-#define LVGL_TICK_PERIOD_MS 2
-#define LVGL_TASK_MAX_DELAY_MS 500
-#define LVGL_TASK_MIN_DELAY_MS 1
-#define LVGL_TASK_STACK_SIZE (4 * 1024)
-#define LVGL_TASK_PRIORITY 2
+// Display server targets
+enum {
+    DISPLAY_TARGET_LABEL,
+};
 
-static SemaphoreHandle_t lvglMutex = NULL;
+#define LVGL_TICK_PERIOD_MS 2
 
 static lv_disp_draw_buf_t disp_buf; // contains internal graphic buffer(s) called draw buffer(s)
 
@@ -60,6 +62,7 @@ extern "C" {
  */
 static void lvglFlushCallback(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
 {
+    displayStatsFlushBegin(lv_disp_flush_is_last(drv));
     int offsetx1 = area->x1;
     int offsetx2 = area->x2;
     int offsety1 = area->y1;
@@ -73,51 +76,16 @@ static void lvglTick(void *arg)
     lv_tick_inc(LVGL_TICK_PERIOD_MS);
 }
 
-bool lvglLock(int timeout_ms)
-{
-    // Convert timeout in milliseconds to FreeRTOS ticks
-    // If `timeout_ms` is set to -1, the program will block until the condition is met
-    const TickType_t timeout_ticks = (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
-    return xSemaphoreTakeRecursive(lvglMutex, timeout_ticks) == pdTRUE;
-}
-
-void lvglUnlock(void)
+/**
+ * @brief Build the UI, run by the display server task that owns LVGL
+ */
+static void uiStart(void)
 {
-    xSemaphoreGiveRecursive(lvglMutex);
-}
+    // The layout lives in ui.c, the host benchmark renders the same one
+    lv_obj_t *label = uiCreate(lv_scr_act());
 
-static void lvglTask(void *arg)
-{
-    ESP_LOGI(TAG, "Starting LVGL task");
-    uint32_t task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
-
-    // Create a screen and a label
-    lv_obj_t *screen = lv_scr_act();  // Get the active screen
-
-    // Draw a rectangle
-    lv_obj_t *rect = lv_obj_create(screen);  // Create a rectangle object
-    lv_obj_set_size(rect, 100, 50);          // Set size (width x height)
-    lv_obj_align(rect, LV_ALIGN_CENTER, 0, 0); // Align to center of the screen
-    lv_obj_set_style_bg_color(rect, LV_COLOR_MAKE(0, 0, 255), 0); // Set background color (red)
-
-    // Draw some text
-    lv_obj_t *label = lv_label_create(screen);  // Create a label object
-    lv_label_set_text(label, "Ola Uriel!");   // Set the text
-    lv_obj_align(label, LV_ALIGN_CENTER, 0, 60); // Align below the rectangle
-
-    while (1) {
-        // Lock the mutex due to the LVGL APIs are not thread-safe
-        if (lvglLock(-1)) {
-            task_delay_ms = lv_timer_handler();  // Process LVGL tasks
-            lvglUnlock();              // Release the mutex
-        }
-        if (task_delay_ms > LVGL_TASK_MAX_DELAY_MS) {
-            task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
-        } else if (task_delay_ms < LVGL_TASK_MIN_DELAY_MS) {
-            task_delay_ms = LVGL_TASK_MIN_DELAY_MS;
-        }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));  // Delay to control task execution rate
-    }
+    // Other tasks can change the text with displayServerSetText(DISPLAY_TARGET_LABEL, ...)
+    displayServerRegisterLabel(DISPLAY_TARGET_LABEL, label);
 }
 
 extern "C" void app_main(void)
@@ -138,11 +106,11 @@ extern "C" void app_main(void)
 
     // alloc draw buffers used by LVGL
     // it's recommended to choose the size of the draw buffer(s) to be at least 1/10 screen sized
-    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(AMOLED_HEIGHT * 20 * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(AMOLED_HEIGHT * DISPLAY_DRAW_BUF_LINES * sizeof(lv_color_t), MALLOC_CAP_DMA);
     assert(buf1);
-    lv_color_t *buf2 = (lv_color_t *) heap_caps_malloc(AMOLED_HEIGHT * 20 * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t *buf2 = (lv_color_t *) heap_caps_malloc(AMOLED_HEIGHT * DISPLAY_DRAW_BUF_LINES * sizeof(lv_color_t), MALLOC_CAP_DMA);
     assert(buf2);
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, AMOLED_HEIGHT * 20);
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, AMOLED_HEIGHT * DISPLAY_DRAW_BUF_LINES);
 
 
     ESP_LOGI(TAG, "Register display driver to LVGL");
@@ -154,6 +122,11 @@ extern "C" void app_main(void)
     disp_drv.full_refresh = DISPLAY_FULLRESH;
     lv_disp_drv_register(&disp_drv);
 
+    // The benchmark takes its per-scene numbers from the frame statistics
+    if (DISPLAY_STATS || DISPLAY_LVGL_BENCHMARK) {
+        displayStatsInit(DISPLAY_STATS_OVERLAY);
+    }
+
     ESP_LOGI(TAG, "Install LVGL tick timer");
     // Tick interface for LVGL (using esp_timer to generate 2ms periodic event)
     const esp_timer_create_args_t lvgl_tick_timer_args = {
@@ -167,11 +140,14 @@ extern "C" void app_main(void)
     ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
     ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, LVGL_TICK_PERIOD_MS * 1000));
 
-    lvglMutex = xSemaphoreCreateRecursiveMutex();
-    assert(lvglMutex);
-
-    // tskIDLE_PRIORITY,
-    ESP_LOGI(TAG, "Create LVGL task");
-    xTaskCreate(lvglTask, "LVGL", LVGL_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL);
+    // LVGL belongs to the display server task from here on
+    displayServerConfig_t serverConfig = {};
+    if (DISPLAY_LVGL_BENCHMARK) {
+        serverConfig.onStart = lvglBenchmarkStart;
+        serverConfig.onFrame = lvglBenchmarkProcess;
+    } else {
+        serverConfig.onStart = uiStart;
+    }
+    displayServerStart(&serverConfig);
 
 }
@@ -32,6 +32,20 @@
 
 #define DISPLAY_FULLRESH     false
 
+// SPI pixel clock and LVGL draw buffer height in lines (two buffers of
+// AMOLED_HEIGHT * lines pixels, at most 80 lines for the SPI transfer size)
+#define DISPLAY_PIXEL_CLOCK_HZ      (27 * 1000 * 1000)
+#define DISPLAY_DRAW_BUF_LINES      20
+
+// Boot into lv_demo_benchmark instead of the UI and print the per-scene
+// results as JSON lines (needs CONFIG_LV_USE_DEMO_BENCHMARK)
+#define DISPLAY_LVGL_BENCHMARK      false
+
+// Log FPS, render/flush time percentiles and LVGL memory use once per second.
+// The overlay shows the same numbers on the top layer of the screen.
+#define DISPLAY_STATS               true
+#define DISPLAY_STATS_OVERLAY       false
+
 
 
 
@@ -16,8 +16,9 @@
 #include "esp_idf_version.h"
 #include "driver/spi_master.h"
 #include "lvgl.h"
+#include "displayStats.h"
 
-#define EXAMPLE_LCD_PIXEL_CLOCK_HZ     (27 * 1000 * 1000)
+#define EXAMPLE_LCD_PIXEL_CLOCK_HZ     DISPLAY_PIXEL_CLOCK_HZ
 #define EXAMPLE_LCD_CMD_BITS           8
 #define EXAMPLE_LCD_PARAM_BITS         8
 #define LCD_HOST                       SPI2_HOST
@@ -34,6 +35,8 @@ void display_push_colors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight,
 
 bool display_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
 {
+    displayStatsDmaDone();
+    displayStatsFlushDone();
     lv_disp_flush_ready(&disp_drv);
     return false;
 }
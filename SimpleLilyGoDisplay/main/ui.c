@@ -0,0 +1,41 @@
+/// \file		ui.c
+///
+/// \brief	Screen layout, plain LVGL so it also builds for the host
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include "lvgl.h"
+#include "ui.h"
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+lv_obj_t *uiCreate(lv_obj_t *screen)
+{
+    // Draw a rectangle
+    lv_obj_t *rect = lv_obj_create(screen);  // Create a rectangle object
+    lv_obj_set_size(rect, 100, 50);          // Set size (width x height)
+    lv_obj_align(rect, LV_ALIGN_CENTER, 0, 0); // Align to center of the screen
+    lv_obj_set_style_bg_color(rect, LV_COLOR_MAKE(0, 0, 255), 0); // Set background color (blue)
+
+    // Draw some text
+    lv_obj_t *label = lv_label_create(screen);  // Create a label object
+    lv_label_set_text(label, "Ola Uriel!");   // Set the text
+    lv_obj_align(label, LV_ALIGN_CENTER, 0, 60); // Align below the rectangle
+
+    return label;
+}
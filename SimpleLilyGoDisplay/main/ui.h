@@ -0,0 +1,46 @@
+/// \file		ui.h
+///
+/// \brief	Screen layout, plain LVGL so it also builds for the host
+///
+/// \author		Uriel Abe Contardi (urielcontardi@hotmail.com)
+/// \date		18-10-2026
+///
+/// \version	1.0
+///
+/// \note		Revisions:
+/// 			18-10-2026 <urielcontardi@hotmail.com>
+/// 			First revision.
+
+#pragma once
+#ifndef UI_H
+#define UI_H
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                               INCLUDES                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+//                            EXPORTED FUNCTIONS                            //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Build the widgets on \p screen
+ *
+ * @return The label showing the text posted by other tasks
+ */
+lv_obj_t *uiCreate(lv_obj_t *screen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_H